@@ -0,0 +1,82 @@
+// Scaling benchmark for the composition search (CompositionOptimizer::optimize
+// with OptimizerParams::searchThreads) at 1, 2, 4 and 8 threads. "cold" clears
+// the edit cache first, so regions are solved by the threads that reach them;
+// "warm" reuses it and times the search alone.
+// Usage: vimficiency_composition_bench [words] [repeats]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Editor/NavContext.h"
+#include "Optimizer/CompositionOptimizer.h"
+#include "Optimizer/Config.h"
+#include "Utils/Lines.h"
+
+using namespace std;
+
+namespace {
+
+// The cursor's line, `words` words long, has every word replaced
+pair<Lines, Lines> replaceLineAtCursor(int words) {
+  string oldLine = "x";
+  string newLine = "y";
+  for (int i = 1; i < words; i++) {
+    oldLine += " w" + to_string(i);
+    newLine += " v" + to_string(i * 7);
+  }
+  Lines before = {oldLine, "  // unchanged"};
+  Lines after = {newLine, "  // unchanged"};
+  return {before, after};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int words = argc > 1 ? atoi(argv[1]) : 8;
+  int repeats = argc > 2 ? atoi(argv[2]) : 3;
+
+  auto [before, after] = replaceLineAtCursor(words);
+  NavContext navContext(40, 20);
+  string userSequence = "cc" + after[0] + "<Esc>";
+
+  CompositionOptimizer optimizer(Config::qwerty());
+  OptimizerParams params(10, 1000000, 1.0, 3.0);
+
+  auto timeSearch = [&](bool cold, vector<Result>& results) {
+    double best = 1e18;
+    for (int r = 0; r < repeats; r++) {
+      if (cold) optimizer.editCache->clear();
+      auto begin = chrono::steady_clock::now();
+      results = optimizer.optimize(before, Position(0, 0), after, Position(0, 0), userSequence,
+                                   navContext, ImpliedExclusions(), EXPLORABLE_MOTIONS, params);
+      auto end = chrono::steady_clock::now();
+      best = min(best, chrono::duration<double, milli>(end - begin).count());
+    }
+    return best;
+  };
+
+  cout << words << " words, best of " << repeats << "\n";
+  double coldBaseline = 0;
+  double warmBaseline = 0;
+  for (int threads : {1, 2, 4, 8}) {
+    params.searchThreads = threads;
+    vector<Result> results;
+    double cold = timeSearch(true, results);
+    double warm = timeSearch(false, results);
+    if (threads == 1) {
+      coldBaseline = cold;
+      warmBaseline = warm;
+    }
+    cout << setw(2) << threads << " threads: cold " << fixed << setprecision(1) << setw(9) << cold
+         << " ms (x" << setprecision(2) << coldBaseline / cold << ")  warm "
+         << setprecision(1) << setw(9) << warm
+         << " ms (x" << setprecision(2) << warmBaseline / warm << ")  "
+         << results.size() << " results, best "
+         << (results.empty() ? 0.0 : results[0].keyCost) << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,65 @@
+// Benchmark for Myers::calculate on large buffers.
+// Builds a buffer of generated code lines, changes a number of scattered
+// lines, and times the character-level diff.
+// Usage: vimficiency_diff_bench [lines] [edits] [repeats]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Optimizer/DiffState.h"
+#include "Utils/Lines.h"
+
+using namespace std;
+
+namespace {
+
+pair<Lines, Lines> scatteredEdits(int lines, int edits) {
+  mt19937 rng(7);
+  Lines before;
+  for (int i = 0; i < lines; i++) {
+    before.push_back("  auto value" + to_string(i) + " = lookup(table, " + to_string(rng() % 997) + ");");
+  }
+
+  Lines after = before;
+  for (int e = 0; e < edits; e++) {
+    string& line = after[rng() % lines];
+    size_t call = line.find("lookup");
+    if (e % 3 == 0 && call != string::npos) {
+      line.replace(call, 6, "find");
+    } else if (e % 3 == 1) {
+      line.insert(line.size() - 1, ", fallback");
+    } else {
+      line.erase(2, 5);
+    }
+  }
+  return {before, after};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int lines = argc > 1 ? atoi(argv[1]) : 10000;
+  int repeats = argc > 3 ? atoi(argv[3]) : 3;
+
+  cout << lines << " lines, best of " << repeats << "\n";
+  for (int edits : {argc > 2 ? atoi(argv[2]) : 100, 300, 1000}) {
+    auto [before, after] = scatteredEdits(lines, edits);
+    double best = 1e18;
+    size_t regions = 0;
+    for (int r = 0; r < repeats; r++) {
+      auto begin = chrono::steady_clock::now();
+      vector<DiffState> diffs = Myers::calculate(before, after);
+      auto end = chrono::steady_clock::now();
+      best = min(best, chrono::duration<double, milli>(end - begin).count());
+      regions = diffs.size();
+    }
+    cout << setw(5) << edits << " edits: " << setw(5) << regions << " regions in "
+         << fixed << setprecision(1) << setw(8) << best << " ms\n";
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+// Scaling benchmark for edit region solving (OptimizerParams::threads) at 1,
+// 2, 4 and 8 threads. Builds buffers with many independent changed regions
+// (renames on every other line) and times cold CompositionOptimizer::optimize
+// runs, with the edit cache cleared and the search itself on one thread, so
+// only the regions solved ahead of the search and the parallel deletion
+// solves change with the thread count.
+// Usage: vimficiency_bench [regions] [repeats]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Editor/NavContext.h"
+#include "Optimizer/CompositionOptimizer.h"
+#include "Optimizer/Config.h"
+#include "Utils/Lines.h"
+
+using namespace std;
+
+namespace {
+
+// Distinct identifier for each region, so no two regions share a solve
+string identifier(int i) {
+  string id = "id";
+  for (int k = 0; k < 4; k++, i /= 26) {
+    id += static_cast<char>('a' + i % 26);
+  }
+  return id;
+}
+
+// Every other line calls a differently named function, which the end buffer
+// renames to one common name
+pair<Lines, Lines> renameBuffers(int regions) {
+  Lines before;
+  Lines after;
+  for (int i = 0; i < regions; i++) {
+    before.push_back("  int value = " + identifier(i * 7919) + "(arg);");
+    after.push_back("  int value = handler(arg);");
+    before.push_back("  // unchanged " + to_string(i));
+    after.push_back("  // unchanged " + to_string(i));
+  }
+  return {before, after};
+}
+
+// Walks down to each call and renames it
+string renameSequence(int regions) {
+  string seq;
+  for (int i = 0; i < regions; i++) {
+    if (i > 0) seq += "jj";
+    seq += "^wwwcwhandler<Esc>";
+  }
+  return seq;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int regions = argc > 1 ? atoi(argv[1]) : 16;
+  int repeats = argc > 2 ? atoi(argv[2]) : 3;
+
+  auto [before, after] = renameBuffers(regions);
+  string userSequence = renameSequence(regions);
+  NavContext navContext(40, 20);
+
+  CompositionOptimizer optimizer(Config::uniform());
+  OptimizerParams params(5);
+  params.searchThreads = 1;
+  cout << regions << " regions, best of " << repeats << "\n";
+
+  double baseline = 0;
+  for (int threads : {1, 2, 4, 8}) {
+    params.threads = threads;
+    vector<Result> results;
+    double best = 1e18;
+    for (int r = 0; r < repeats; r++) {
+      optimizer.editCache->clear();
+      auto begin = chrono::steady_clock::now();
+      results = optimizer.optimize(before, Position(0, 0), after, Position(0, 0), userSequence,
+                                   navContext, ImpliedExclusions(), EXPLORABLE_MOTIONS, params);
+      auto end = chrono::steady_clock::now();
+      best = min(best, chrono::duration<double, milli>(end - begin).count());
+    }
+    if (threads == 1) baseline = best;
+    cout << setw(2) << threads << " threads: " << fixed << setprecision(1) << setw(9) << best
+         << " ms  (x" << setprecision(2) << baseline / best << ")  "
+         << results.size() << " results, best "
+         << (results.empty() ? 0.0 : results[0].keyCost) << "\n";
+  }
+  return 0;
+}
@@ -8,6 +8,7 @@ local M = {
   SLICE_EXPAND_TO_PARAGRAPH = false,
   MAX_SEARCH_LINES = 500,
   KEY_SESSION_CAPACITY = 10, -- Max rolling key sessions (aliases: 1-N)
+  ANALYSIS_POLL_MS = 20, -- How often finish() checks on its background analysis
 }
 
 return M
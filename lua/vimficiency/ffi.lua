@@ -38,7 +38,14 @@ local M = {}
 ---@field vimficiency_hand_name fun(index: integer): ffi.cdata*
 ---@field vimficiency_get_config fun(): VimficiencyConfigFFI
 ---@field vimficiency_apply_config fun(): nil
----@field vimficiency_analyze fun(text: string, includes_real_top: boolean, includes_real_bottom: boolean, start_row: integer, start_col: integer, end_row: integer, end_col: integer, keyseq: string, top_row: integer, bottom_row: integer, window_height: integer, scroll_amount: integer, results_calculated: integer): string
+---@field vimficiency_create fun(): ffi.cdata*
+---@field vimficiency_destroy fun(handle: ffi.cdata*): nil
+---@field vimficiency_analyze fun(handle: ffi.cdata*, text: string, includes_real_top: boolean, includes_real_bottom: boolean, start_row: integer, start_col: integer, end_row: integer, end_col: integer, keyseq: string, top_row: integer, bottom_row: integer, window_height: integer, scroll_amount: integer, results_calculated: integer): ffi.cdata*
+---@field vimficiency_submit fun(handle: ffi.cdata*, text: string, includes_real_top: boolean, includes_real_bottom: boolean, start_row: integer, start_col: integer, end_row: integer, end_col: integer, keyseq: string, top_row: integer, bottom_row: integer, window_height: integer, scroll_amount: integer, results_calculated: integer): integer
+---@field vimficiency_poll fun(handle: ffi.cdata*, job_id: integer): ffi.cdata*
+---@field vimficiency_cancel fun(handle: ffi.cdata*, job_id: integer): nil
+---@field vimficiency_cache_stats fun(handle: ffi.cdata*): ffi.cdata*
+---@field vimficiency_set_cache_capacity fun(handle: ffi.cdata*, max_bytes: integer): nil
 ---@field vimficiency_get_debug fun(): string
 ---@field vimficiency_version fun(): integer
 ---@field vimficiency_debug_config fun(): string
@@ -78,13 +85,72 @@ ffi.cdef([[
     const char* vimficiency_key_name(int index);
     const char* vimficiency_finger_name(int index);
     const char* vimficiency_hand_name(int index);
-    const char* vimficiency_analyze(
+
+    typedef struct {
+        int mode;
+        const char* keys;
+        size_t keys_len;
+    } VimficiencySegment;
+
+    typedef struct {
+        const char* seq;
+        size_t seq_len;
+        double cost;
+        int end_row;
+        int end_col;
+        const VimficiencySegment* segments;
+        size_t segment_count;
+    } VimficiencyResult;
+
+    typedef struct {
+        int explored;
+        double user_effort;
+        double elapsed_ms;
+        bool cancelled;
+        bool cached;
+    } VimficiencyStats;
+
+    typedef struct {
+        const char* error;
+        const VimficiencyResult* results;
+        size_t count;
+        const char* debug;
+        size_t debug_len;
+        VimficiencyStats stats;
+    } VimficiencyResults;
+
+    typedef struct VimficiencyHandle VimficiencyHandle;
+    VimficiencyHandle* vimficiency_create();
+    void vimficiency_destroy(VimficiencyHandle* handle);
+
+    const VimficiencyResults* vimficiency_analyze(
+        VimficiencyHandle* handle,
         const char* text, bool includes_real_top, bool includes_real_bottom,
         int start_row, int start_col, int end_row, int end_col,
         const char* keyseq,
         int top_row, int bottom_row, int window_height, int scroll_amount,
         int RESULTS_CALCULATED
     );
+    int vimficiency_submit(
+        VimficiencyHandle* handle,
+        const char* text, bool includes_real_top, bool includes_real_bottom,
+        int start_row, int start_col, int end_row, int end_col,
+        const char* keyseq,
+        int top_row, int bottom_row, int window_height, int scroll_amount,
+        int RESULTS_CALCULATED
+    );
+    const VimficiencyResults* vimficiency_poll(VimficiencyHandle* handle, int job_id);
+    void vimficiency_cancel(VimficiencyHandle* handle, int job_id);
+
+    typedef struct {
+        uint64_t hits;
+        uint64_t misses;
+        size_t entries;
+        size_t bytes;
+        size_t max_bytes;
+    } VimficiencyCacheStats;
+    VimficiencyCacheStats vimficiency_cache_stats(VimficiencyHandle* handle);
+    void vimficiency_set_cache_capacity(VimficiencyHandle* handle, size_t max_bytes);
     const char* vimficiency_get_debug();
 
     int vimficiency_version();
@@ -134,6 +200,66 @@ local function build_enum(count, name_fn)
 	return t
 end
 
+local MODE_NAMES = { [0] = "Normal", [1] = "Insert", [2] = "Visual" }
+
+--- Copy a VimficiencyResults out of the library's arena (only valid until the
+--- next analyze/poll call) into Lua tables.
+---@param out ffi.cdata*
+---@return VimficiencyResult[] results, string debug, VimficiencyStats stats
+local function read_results(out)
+  if out.error ~= nil then
+    error(ffi.string(out.error))
+  end
+
+  ---@class VimficiencySegment
+  ---@field mode string "Normal" | "Insert" | "Visual"
+  ---@field keys string
+
+  ---@class VimficiencyResult
+  ---@field seq string Motion sequence
+  ---@field cost number Effort cost
+  ---@field end_row integer (0-indexed)
+  ---@field end_col integer (0-indexed)
+  ---@field segments VimficiencySegment[]
+
+  ---@type VimficiencyResult[]
+  local results = {}
+  for i = 0, tonumber(out.count) - 1 do
+    local r = out.results[i]
+    local segments = {}
+    for j = 0, tonumber(r.segment_count) - 1 do
+      local seg = r.segments[j]
+      table.insert(segments, {
+        mode = MODE_NAMES[seg.mode],
+        keys = ffi.string(seg.keys, seg.keys_len),
+      })
+    end
+    table.insert(results, {
+      seq = ffi.string(r.seq, r.seq_len),
+      cost = r.cost,
+      end_row = r.end_row,
+      end_col = r.end_col,
+      segments = segments,
+    })
+  end
+
+  ---@class VimficiencyStats
+  ---@field explored integer States expanded by the search
+  ---@field user_effort number Effort of the user's own sequence
+  ---@field elapsed_ms number
+  ---@field cancelled boolean
+  ---@field cached boolean Answered from the result cache without searching
+  local stats = {
+    explored = out.stats.explored,
+    user_effort = out.stats.user_effort,
+    elapsed_ms = out.stats.elapsed_ms,
+    cancelled = out.stats.cancelled,
+    cached = out.stats.cached,
+  }
+
+  return results, ffi.string(out.debug, out.debug_len), stats
+end
+
 -------- END Local Helper Functions --------
 
 ---@type VimficiencyLib
@@ -143,6 +269,9 @@ M.Key = build_enum(lib.VIMFICIENCY_KEY_COUNT, lib.vimficiency_key_name)
 M.Finger = build_enum(lib.VIMFICIENCY_FINGER_COUNT, lib.vimficiency_finger_name)
 M.Hand = build_enum(lib.VIMFICIENCY_HAND_COUNT, lib.vimficiency_hand_name)
 
+-- Owns result storage and background jobs for this plugin instance
+local handle = ffi.gc(lib.vimficiency_create(), lib.vimficiency_destroy)
+
 -- ---@param user_config VimficiencyConfigFFI
 function M.configure(user_config)
 	---@type VimficiencyConfigFFI
@@ -190,6 +319,10 @@ function M.configure(user_config)
     config.slice_buffer_count = user_config.slice_buffer_amount
   end
 
+  if user_config.result_cache_bytes then
+    lib.vimficiency_set_cache_capacity(handle, user_config.result_cache_bytes)
+  end
+
 	lib.vimficiency_apply_config()
 end
 
@@ -206,7 +339,7 @@ end
 ---@param window_height integer
 ---@param scroll_amount integer
 ---@param RESULTS_CALCULATED integer
----@return VimficiencyResult[] results, string debug
+---@return VimficiencyResult[] results, string debug, VimficiencyStats stats
 function M.analyze(
   lines, includes_real_top, includes_real_bottom,
   start_row, start_col, end_row, end_col,
@@ -217,42 +350,70 @@ function M.analyze(
 	local text = table.concat(lines, "\n")
 
 	local result = lib.vimficiency_analyze(
-    text, includes_real_top, includes_real_bottom,
+    handle, text, includes_real_top, includes_real_bottom,
     start_row, start_col, end_row, end_col,
     key_seq,
     top_row, bottom_row, window_height, scroll_amount,
     RESULTS_CALCULATED
   )
-  local dbg = ffi.string(lib.vimficiency_get_debug())
-  local result_str = ffi.string(result)
+  return read_results(result)
+end
 
-  -- Check for error from C++
-  if result_str:sub(1, 6) == "ERROR:" then
-    error(result_str)
-  end
+--- Start an analysis on a background worker. Same arguments as M.analyze.
+---@return integer job_id
+function M.submit(
+  lines, includes_real_top, includes_real_bottom,
+  start_row, start_col, end_row, end_col,
+  key_seq,
+  top_row, bottom_row, window_height, scroll_amount,
+  RESULTS_CALCULATED
+)
+  local text = table.concat(lines, "\n")
 
-  -- Parse results: format is "size: N\nseq1 cost1\nseq2 cost2\n..."
-  ---@class VimficiencyResult
-  ---@field seq string Motion sequence
-  ---@field cost number Effort cost
+  return lib.vimficiency_submit(
+    handle, text, includes_real_top, includes_real_bottom,
+    start_row, start_col, end_row, end_col,
+    key_seq,
+    top_row, bottom_row, window_height, scroll_amount,
+    RESULTS_CALCULATED
+  )
+end
 
-  ---@type VimficiencyResult[]
-  local results = {}
-  local line_num = 0
-  for line in result_str:gmatch("[^\n]+") do
-    line_num = line_num + 1
-    if line_num > 1 then  -- Skip "size: N" header
-      local seq, cost_str = line:match("^(%S+)%s+(%S+)")
-      if seq then
-        table.insert(results, {
-          seq = seq,
-          cost = tonumber(cost_str) or 0
-        })
-      end
-    end
+--- Check on a submitted job. Returns nil while it is still running.
+--- Once finished the job is forgotten, so this returns results only once.
+---@param job_id integer
+---@return VimficiencyResult[]|nil results, string|nil debug, VimficiencyStats|nil stats
+function M.poll(job_id)
+  local result = lib.vimficiency_poll(handle, job_id)
+  if result == nil then
+    return nil, nil, nil
   end
+  return read_results(result)
+end
+
+--- Stop a submitted job. Its results are discarded.
+---@param job_id integer
+function M.cancel(job_id)
+  lib.vimficiency_cancel(handle, job_id)
+end
 
-  return results, dbg
+---@class VimficiencyCacheStats
+---@field hits integer
+---@field misses integer
+---@field entries integer
+---@field bytes integer Estimated memory held by cached results
+---@field max_bytes integer
+
+---@return VimficiencyCacheStats
+function M.cache_stats()
+  local stats = lib.vimficiency_cache_stats(handle)
+  return {
+    hits = tonumber(stats.hits),
+    misses = tonumber(stats.misses),
+    entries = tonumber(stats.entries),
+    bytes = tonumber(stats.bytes),
+    max_bytes = tonumber(stats.max_bytes),
+  }
 end
 
 function M.version()
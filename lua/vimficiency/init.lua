@@ -114,6 +114,9 @@ subcommands.list = {
 		else
 			table.insert(lines, "Saved results: (none)")
 		end
+		local cache = ffi_lib.cache_stats()
+		table.insert(lines, string.format("Result cache: %d hits, %d misses, %d entries (%d/%d KB)",
+			cache.hits, cache.misses, cache.entries, math.floor(cache.bytes / 1024), math.floor(cache.max_bytes / 1024)))
 		vim.notify(table.concat(lines, "\n"), vim.log.levels.INFO)
 	end,
 }
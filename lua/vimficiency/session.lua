@@ -8,8 +8,26 @@ local session_store = require("vimficiency.session_store")
 
 local M = {}
 
+--- Background analyses still running, by alias.
+---@type table<string, { job_id: integer, timer: uv.uv_timer_t }>
+local pending_jobs = {}
+
 -------- Local functions BEGIN --------
 
+--- Cancel the alias's running analysis, if any. Used when a newer session or
+--- finish() supersedes it.
+---@param alias string
+local function cancel_pending(alias)
+  local pending = pending_jobs[alias]
+  if not pending then
+    return
+  end
+  pending_jobs[alias] = nil
+  pending.timer:stop()
+  pending.timer:close()
+  ffi_lib.cancel(pending.job_id)
+end
+
 -- Approximate motion conversions: screen-line motions -> buffer-line equivalents
 -- These are NOT exact (gj/gk work on display lines, j/k on buffer lines) but
 -- are close enough for optimization comparison purposes.
@@ -103,6 +121,63 @@ local function load_results(name)
   return data, nil
 end
 
+--- Store and report the results of a finished analysis.
+---@param alias string
+---@param save_name string|nil
+---@param active ActiveSession
+---@param inputs table  Analysis inputs: lines, start/end row/col (relative to lines), user_seq
+---@param results VimficiencyResult[]
+---@param dbg string|nil
+local function complete_finish(alias, save_name, active, inputs, results, dbg)
+  -- Persist debug by writing to file
+  if dbg and dbg ~= "" then
+    local debug_dir = vim.fn.stdpath("data") .. "/vimficiency/debug"
+    vim.fn.mkdir(debug_dir, "p")
+    local debug_path = debug_dir .. "/" .. active.id .. ".txt"
+    vim.fn.writefile(vim.split(dbg, "\n"), debug_path)
+  end
+
+  -- Limit stored results to RESULTS_SAVED
+  ---@type VimficiencyResult[]
+  local optimal_results = {}
+  for i = 1, math.min(#results, config.RESULTS_SAVED) do
+    table.insert(optimal_results, results[i])
+  end
+
+  -- Create result and transition from active to result storage
+  ---@type ResultSession
+  local result = vim.tbl_extend("force", inputs, {
+    optimal_results = optimal_results,
+    timestamp = vim.uv.hrtime(),
+  })
+
+  -- This detaches key tracking and moves from active to result storage
+  if not session_store.finish_session(alias, result) then
+    total_failure(alias, "finish()", "failed to store result")
+    return
+  end
+
+  -- Optionally save to disk
+  local save_msg = ""
+  if save_name and save_name ~= "" then
+    local save_ok, save_err = save_results(save_name, result)
+    if save_ok then
+      save_msg = "\nsaved to: " .. save_name
+    else
+      save_msg = "\nsave failed: " .. (save_err or "unknown error")
+    end
+  end
+
+  -- Format result summary with position and all results
+  local pos_str = string.format("(%d,%d) -> (%d,%d)",
+    result.start_row, result.start_col, result.end_row, result.end_col)
+  local result_display = format_results_display(optimal_results, result.user_seq)
+  vim.notify(
+    "vimficiency finished [" .. alias .. "] " .. pos_str .. save_msg .. "\n" .. result_display,
+    vim.log.levels.INFO
+  )
+end
+
 -------- Local functions END --------
 
 ---@param alias string  The alias for the session (required, must be manual type)
@@ -129,6 +204,8 @@ function M.start(alias)
     return
   end
 
+  cancel_pending(alias)
+
   local buf = v.nvim_get_current_buf()
   local win = v.nvim_get_current_win()
   local id = util.new_id(buf)
@@ -206,9 +283,20 @@ function M.finish(alias, save_name)
   local rel_end_row = end_state.row - start_search
   local rel_end_col = end_state.col
 
-  ---@type boolean, VimficiencyResult[], string
-  local ok, results, dbg = pcall(
-    ffi_lib.analyze,
+  local inputs = {
+    lines = lines,
+    start_row = rel_start_row,  -- 0-indexed, relative to lines
+    start_col = rel_start_col,
+    end_row = rel_end_row,      -- 0-indexed, relative to lines
+    end_col = rel_end_col,
+    user_seq = keyseq_str,
+  }
+
+  cancel_pending(alias)
+
+  ---@type boolean, integer
+  local ok, job_id = pcall(
+    ffi_lib.submit,
     lines,
     start_search == 0,
     end_search == buffer_line_count - 1,
@@ -225,63 +313,43 @@ function M.finish(alias, save_name)
   )
 
   if not ok then
-    total_failure(alias, "finish() error", "FFI error: " .. tostring(results))
+    total_failure(alias, "finish() error", "FFI error: " .. tostring(job_id))
     return
   end
 
-  -- Persist debug by writing to file
-  if dbg and dbg ~= "" then
-    local debug_dir = vim.fn.stdpath("data") .. "/vimficiency/debug"
-    vim.fn.mkdir(debug_dir, "p")
-    local debug_path = debug_dir .. "/" .. active.id .. ".txt"
-    vim.fn.writefile(vim.split(dbg, "\n"), debug_path)
-  end
+  -- Collect results from a timer so the editor stays responsive while the
+  -- worker searches.
+  local timer = assert(vim.uv.new_timer())
+  local pending = { job_id = job_id, timer = timer }
+  pending_jobs[alias] = pending
 
-  -- Limit stored results to RESULTS_SAVED
-  ---@type VimficiencyResult[]
-  local optimal_results = {}
-  for i = 1, math.min(#results, config.RESULTS_SAVED) do
-    table.insert(optimal_results, results[i])
-  end
+  timer:start(config.ANALYSIS_POLL_MS, config.ANALYSIS_POLL_MS, vim.schedule_wrap(function()
+    -- Superseded or cancelled since this callback was queued
+    if pending_jobs[alias] ~= pending then
+      return
+    end
 
-  -- Create result and transition from active to result storage
-  ---@type ResultSession
-  local result = {
-    lines = lines,
-    start_row = rel_start_row,  -- 0-indexed, relative to lines
-    start_col = rel_start_col,
-    end_row = rel_end_row,      -- 0-indexed, relative to lines
-    end_col = rel_end_col,
-    user_seq = keyseq_str,
-    optimal_results = optimal_results,
-    timestamp = vim.uv.hrtime(),
-  }
+    local poll_ok, results, dbg = pcall(ffi_lib.poll, job_id)
+    if poll_ok and results == nil then
+      return -- still running
+    end
 
-  -- This detaches key tracking and moves from active to result storage
-  if not session_store.finish_session(alias, result) then
-    total_failure(alias, "finish()", "failed to store result")
-    return
-  end
+    pending_jobs[alias] = nil
+    timer:stop()
+    timer:close()
 
-  -- Optionally save to disk
-  local save_msg = ""
-  if save_name and save_name ~= "" then
-    local save_ok, save_err = save_results(save_name, result)
-    if save_ok then
-      save_msg = "\nsaved to: " .. save_name
-    else
-      save_msg = "\nsave failed: " .. (save_err or "unknown error")
+    if not poll_ok then
+      total_failure(alias, "finish() error", "FFI error: " .. tostring(results))
+      return
     end
-  end
 
-  -- Format result summary with position and all results
-  local pos_str = string.format("(%d,%d) -> (%d,%d)",
-    rel_start_row, rel_start_col, rel_end_row, rel_end_col)
-  local result_display = format_results_display(optimal_results, keyseq_str)
-  vim.notify(
-    "vimficiency finished [" .. alias .. "] " .. pos_str .. save_msg .. "\n" .. result_display,
-    vim.log.levels.INFO
-  )
+    -- Session was closed or replaced while the analysis ran
+    if session_store.get_active(alias) ~= active then
+      return
+    end
+
+    complete_finish(alias, save_name, active, inputs, results, dbg)
+  end))
 end
 
 --- Close a session without finishing (no optimization, no result stored).
@@ -298,6 +366,7 @@ function M.close(alias)
     return
   end
 
+  cancel_pending(alias)
   session_store.remove(alias)
   vim.notify("vimficiency closed [" .. alias .. "]", vim.log.levels.INFO)
 end
@@ -14,17 +14,6 @@ using namespace std;
 
 namespace Edit {
 
-// Compile-time string hash for switch statements.
-// Uses M=131 (prime > 126) to guarantee collision-free hashing for all strings.
-// Math: hash(s) = s[0]*M^(n-1) + s[1]*M^(n-2) + ... + s[n-1]
-// This is bijective (unique hash per string) until 64-bit overflow at ~10 chars.
-constexpr size_t hash(string_view s) {
-  assert(s.size() <= 10 && "hash() only collision-free for strings <= 10 chars");
-  size_t h = 0;
-  for (char c : s) h = h * 131 + static_cast<unsigned char>(c);
-  return h;
-}
-
 inline void clampToLastChar(const string& line, int& col) {
   col = line.empty() ? 0 : min(col, (int)line.size() - 1);
 }
@@ -105,6 +94,231 @@ void insertText(Lines& lines, Position& pos, Mode mode, const string& text) {
 // Application
 // -----------------------------------------------------------------------------
 
+// Normal-mode edits that work on an empty line (an empty line is a "word" for dw/dW)
+static bool validOnEmptyLine(size_t h) {
+  switch (h) {
+    case hash("i"): case hash("a"): case hash("I"): case hash("A"):
+    // Line operations
+    case hash("o"): case hash("O"): case hash("dd"): case hash("cc"): case hash("S"):
+    case hash("J"): case hash("gJ"):
+    // Word motions (empty line is a "word")
+    case hash("dw"): case hash("dW"):
+    // Navigation motions (position unchanged or vertical move)
+    case hash("j"): case hash("k"):
+    case hash("w"): case hash("W"): case hash("b"): case hash("B"):
+    case hash("e"): case hash("E"): case hash("ge"): case hash("gE"):
+    case hash("0"): case hash("^"): case hash("$"):
+      return true;
+  }
+  return false;
+}
+
+// Mirrors the early throws in applyNavigation and applyEdit.
+EditStatus checkEdit(const Lines& lines, const Position& pos, Mode mode, const ParsedEdit& edit) {
+  string_view e = edit.edit;
+  int count = edit.effectiveCount();
+  size_t h = edit.id;
+
+  if (lines.empty()) {
+    bool opensBuffer = mode == Mode::Normal
+        && (h == hash("i") || h == hash("a") || h == hash("o") || h == hash("O"));
+    return opensBuffer ? EditStatus::Ok : EditStatus::Invalid;
+  }
+
+  const string& line = lines[pos.line];
+  int n = static_cast<int>(lines.size());
+  int m = static_cast<int>(line.size());
+
+  if (mode == Mode::Insert) {
+    switch (h) {
+      case hash("<Esc>"): case hash("<CR>"):
+        return EditStatus::Ok;
+      case hash("<BS>"):
+        return pos.col == 0 && pos.line == 0 ? EditStatus::NoEffect : EditStatus::Ok;
+      case hash("<Del>"):
+        return pos.col >= m && pos.line + 1 >= n ? EditStatus::NoEffect : EditStatus::Ok;
+      case hash("<C-u>"): case hash("<C-w>"): case hash("<Left>"):
+        return pos.col == 0 ? EditStatus::NoEffect : EditStatus::Ok;
+      case hash("<Right>"):
+        return pos.col >= m ? EditStatus::NoEffect : EditStatus::Ok;
+      case hash("<Up>"):
+        return pos.line == 0 ? EditStatus::NoEffect : EditStatus::Ok;
+      case hash("<Down>"):
+        return pos.line + 1 >= n ? EditStatus::NoEffect : EditStatus::Ok;
+    }
+    return EditStatus::Invalid;
+  }
+
+  if (mode != Mode::Normal) {
+    return EditStatus::Invalid;
+  }
+  if (line.empty() && !validOnEmptyLine(h)) {
+    return EditStatus::Invalid;
+  }
+  if (e.size() == 2 && e[0] == 'r') {
+    return pos.col + count > m ? EditStatus::Invalid : EditStatus::Ok;
+  }
+
+  switch (h) {
+    case hash("j"):
+      return pos.line + count >= n ? EditStatus::Invalid : EditStatus::Ok;
+    case hash("k"):
+      return pos.line < count ? EditStatus::Invalid : EditStatus::Ok;
+    case hash("h"):
+      return pos.col < count ? EditStatus::Invalid : EditStatus::Ok;
+    case hash("l"):
+      return pos.col + count >= m ? EditStatus::Invalid : EditStatus::Ok;
+
+    case hash("x"): case hash("~"): case hash("s"):
+      return pos.col + count > m ? EditStatus::Invalid : EditStatus::Ok;
+    case hash("X"):
+      return count > pos.col ? EditStatus::Invalid : EditStatus::Ok;
+    case hash("J"): case hash("gJ"):
+      return pos.line + count >= n ? EditStatus::Invalid : EditStatus::Ok;
+    case hash("dd"): case hash("C"): case hash("c$"): case hash("D"): case hash("d$"):
+      return pos.line + count > n ? EditStatus::Invalid : EditStatus::Ok;
+
+    case hash("db"): case hash("dB"): case hash("dge"): case hash("dgE"):
+    case hash("cb"): case hash("cB"): case hash("cge"): case hash("cgE"):
+      return pos.line == 0 && pos.col == 0 ? EditStatus::NoEffect : EditStatus::Ok;
+    case hash("d0"): case hash("c0"):
+      return pos.col == 0 ? EditStatus::NoEffect : EditStatus::Ok;
+    case hash("d^"): case hash("c^"):
+      return VimUtils::firstNonBlankColInLineStr(line) >= pos.col ? EditStatus::NoEffect
+                                                                   : EditStatus::Ok;
+  }
+  return EditStatus::Ok;
+}
+
+EditStatus tryApplyEdit(Lines& lines, Position& pos, Mode& mode,
+                        const NavContext& navContext, const ParsedEdit& edit) {
+  EditStatus status = checkEdit(lines, pos, mode, edit);
+  if (status != EditStatus::Ok) {
+    return status;
+  }
+  return applyCheckedEdit(lines, pos, mode, navContext, edit);
+}
+
+EditStatus applyCheckedEdit(Lines& lines, Position& pos, Mode& mode,
+                            const NavContext& navContext, const ParsedEdit& edit) {
+  // Rare failures the prechecks don't cover (unknown edits, bad text objects)
+  // throw before touching the buffer, so a restore of pos and mode suffices
+  Position savedPos = pos;
+  Mode savedMode = mode;
+  try {
+    applyEdit(lines, pos, mode, navContext, edit);
+  } catch (const runtime_error&) {
+    pos = savedPos;
+    mode = savedMode;
+    return EditStatus::Invalid;
+  }
+  return EditStatus::Ok;
+}
+
+// Navigation commands never modify the buffer, so they only need it read-only.
+bool applyNavigation(const Lines& lines, Position& pos, Mode mode, const ParsedEdit& edit) {
+  if (mode != Mode::Normal) {
+    return false;
+  }
+
+  string_view e = edit.edit;
+  int count = edit.effectiveCount();
+  switch (edit.id) {
+    case hash("j"): case hash("k"): case hash("h"): case hash("l"):
+    case hash("w"): case hash("W"): case hash("b"): case hash("B"):
+    case hash("e"): case hash("E"): case hash("ge"): case hash("gE"):
+    case hash("0"): case hash("^"): case hash("$"):
+      break;
+    default:
+      return false;
+  }
+
+  if (lines.empty()) {
+    throw runtime_error("Edit '" + string(e) + "' invalid on empty buffer");
+  }
+
+  const string& line = lines[pos.line];
+  int n = static_cast<int>(lines.size());
+  int m = static_cast<int>(line.size());
+
+  switch (edit.id) {
+    case hash("j"):
+      if (pos.line + count >= n) {
+        throw runtime_error("j requires " + to_string(count) + " lines below");
+      }
+      pos.line += count;
+      pos.col = VimMovementUtils::clampCol(lines, pos.targetCol, pos.line);
+      return true;
+
+    case hash("k"):
+      if (pos.line < count) {
+        throw runtime_error("k requires " + to_string(count) + " lines above");
+      }
+      pos.line -= count;
+      pos.col = VimMovementUtils::clampCol(lines, pos.targetCol, pos.line);
+      return true;
+
+    case hash("h"):
+      if (pos.col < count) {
+        throw runtime_error("h requires " + to_string(count) + " chars left");
+      }
+      pos.setCol(pos.col - count);
+      return true;
+
+    case hash("l"):
+      if (pos.col + count >= m) {
+        throw runtime_error("l requires " + to_string(count) + " chars right");
+      }
+      pos.setCol(pos.col + count);
+      return true;
+
+    case hash("w"):
+      for (int i = 0; i < count; i++) VimMovementUtils::motionW(pos, lines, false);
+      return true;
+
+    case hash("W"):
+      for (int i = 0; i < count; i++) VimMovementUtils::motionW(pos, lines, true);
+      return true;
+
+    case hash("b"):
+      for (int i = 0; i < count; i++) VimMovementUtils::motionB(pos, lines, false);
+      return true;
+
+    case hash("B"):
+      for (int i = 0; i < count; i++) VimMovementUtils::motionB(pos, lines, true);
+      return true;
+
+    case hash("e"):
+      for (int i = 0; i < count; i++) VimMovementUtils::motionE(pos, lines, false);
+      return true;
+
+    case hash("E"):
+      for (int i = 0; i < count; i++) VimMovementUtils::motionE(pos, lines, true);
+      return true;
+
+    case hash("ge"):
+      for (int i = 0; i < count; i++) VimMovementUtils::motionGe(pos, lines, false);
+      return true;
+
+    case hash("gE"):
+      for (int i = 0; i < count; i++) VimMovementUtils::motionGe(pos, lines, true);
+      return true;
+
+    case hash("0"):
+      pos.setCol(0);
+      return true;
+
+    case hash("^"):
+      pos.setCol(VimUtils::firstNonBlankColInLineStr(line));
+      return true;
+
+    case hash("$"):
+      pos.setCol(m > 0 ? m - 1 : 0);
+      return true;
+  }
+  return true;
+}
+
 // Error on actions that don't do anything - these should be pruned by search logic.
 // Note: something like 3dw on a line may do nothing on 2nd/3rd dw, but since
 // we can't prune that easily without doing equivalent work as the action, it's fine.
@@ -114,7 +328,7 @@ void applyEdit(Lines& lines, Position& pos, Mode& mode,
                const ParsedEdit& edit) {
   string_view e = edit.edit;
   int count = edit.effectiveCount();
-  size_t h = hash(e);
+  size_t h = edit.id;
 
   // Empty buffer: only switch to insert mode
   if (lines.empty()) {
@@ -140,23 +354,8 @@ void applyEdit(Lines& lines, Position& pos, Mode& mode,
 
   // Empty line: only switch to insert mode, vertical motion, navigation, and word motions
   // (empty line is considered a "word" for dw/dW purposes)
-  if (line.empty() && mode == Mode::Normal) {
-    switch (h) {
-      case hash("i"): case hash("a"): case hash("I"): case hash("A"):
-      // Line operations (valid)
-      case hash("o"): case hash("O"): case hash("dd"): case hash("cc"): case hash("S"):
-      case hash("J"): case hash("gJ"):
-      // Word motions (empty line is a "word")
-      case hash("dw"): case hash("dW"):
-      // Navigation motions (valid on empty lines - position unchanged or vertical move)
-      case hash("j"): case hash("k"):
-      case hash("w"): case hash("W"): case hash("b"): case hash("B"):
-      case hash("e"): case hash("E"): case hash("ge"): case hash("gE"):
-      case hash("0"): case hash("^"): case hash("$"):
-        break;  // Fall through to main switch
-      default:
-        throw runtime_error("Edit '" + string(e) + "' invalid on empty line");
-    }
+  if (line.empty() && mode == Mode::Normal && !validOnEmptyLine(h)) {
+    throw runtime_error("Edit '" + string(e) + "' invalid on empty line");
   }
 
   if (mode == Mode::Normal) {
@@ -173,7 +372,11 @@ void applyEdit(Lines& lines, Position& pos, Mode& mode,
       return;
     }
 
-    switch (hash(e)) {
+    if (applyNavigation(lines, pos, mode, edit)) {
+      return;
+    }
+
+    switch (edit.id) {
       case hash("x"):
         if (pos.col + count > m) {
           throw runtime_error("x requires " + to_string(count) + " chars");
@@ -569,82 +772,6 @@ void applyEdit(Lines& lines, Position& pos, Mode& mode,
           VimEditUtils::deleteRange(lines, r, pos);
         }
         return;
-
-      // --- Navigation motions (for EditOptimizer) ---
-      case hash("j"):
-        if (pos.line + count >= n) {
-          throw runtime_error("j requires " + to_string(count) + " lines below");
-        }
-        pos.line += count;
-        pos.col = VimMovementUtils::clampCol(lines, pos.targetCol, pos.line);
-        return;
-
-      case hash("k"):
-        if (pos.line < count) {
-          throw runtime_error("k requires " + to_string(count) + " lines above");
-        }
-        pos.line -= count;
-        pos.col = VimMovementUtils::clampCol(lines, pos.targetCol, pos.line);
-        return;
-
-      case hash("h"):
-        if (pos.col < count) {
-          throw runtime_error("h requires " + to_string(count) + " chars left");
-        }
-        pos.setCol(pos.col - count);
-        return;
-
-      case hash("l"):
-        if (pos.col + count >= m) {
-          throw runtime_error("l requires " + to_string(count) + " chars right");
-        }
-        pos.setCol(pos.col + count);
-        return;
-
-      case hash("w"):
-        for (int i = 0; i < count; i++) VimMovementUtils::motionW(pos, lines, false);
-        return;
-
-      case hash("W"):
-        for (int i = 0; i < count; i++) VimMovementUtils::motionW(pos, lines, true);
-        return;
-
-      case hash("b"):
-        for (int i = 0; i < count; i++) VimMovementUtils::motionB(pos, lines, false);
-        return;
-
-      case hash("B"):
-        for (int i = 0; i < count; i++) VimMovementUtils::motionB(pos, lines, true);
-        return;
-
-      case hash("e"):
-        for (int i = 0; i < count; i++) VimMovementUtils::motionE(pos, lines, false);
-        return;
-
-      case hash("E"):
-        for (int i = 0; i < count; i++) VimMovementUtils::motionE(pos, lines, true);
-        return;
-
-      case hash("ge"):
-        for (int i = 0; i < count; i++) VimMovementUtils::motionGe(pos, lines, false);
-        return;
-
-      case hash("gE"):
-        for (int i = 0; i < count; i++) VimMovementUtils::motionGe(pos, lines, true);
-        return;
-
-      case hash("0"):
-        pos.setCol(0);
-        return;
-
-      case hash("^"):
-        pos.setCol(VimUtils::firstNonBlankColInLineStr(line));
-        return;
-
-      case hash("$"):
-        pos.setCol(m > 0 ? m - 1 : 0);
-        return;
-
     }
 
     // --- Text object operations: operator + modifier + object ---
@@ -703,7 +830,7 @@ void applyEdit(Lines& lines, Position& pos, Mode& mode,
   }
 
   if (mode == Mode::Insert) {
-    switch (hash(e)) {
+    switch (edit.id) {
       case hash("<Esc>"):
         if (pos.col > 0) pos.col--;
         mode = Mode::Normal;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 #include "Mode.h"
 #include "Position.h"
@@ -8,6 +11,21 @@
 #include "NavContext.h"
 #include "Utils/Lines.h"
 
+namespace Edit {
+
+// Compile-time string hash for switch statements.
+// Uses M=131 (prime > 126) to guarantee collision-free hashing for all strings.
+// Math: hash(s) = s[0]*M^(n-1) + s[1]*M^(n-2) + ... + s[n-1]
+// This is bijective (unique hash per string) until 64-bit overflow at ~10 chars.
+constexpr size_t hash(std::string_view s) {
+  assert(s.size() <= 10 && "hash() only collision-free for strings <= 10 chars");
+  size_t h = 0;
+  for (char c : s) h = h * 131 + static_cast<unsigned char>(c);
+  return h;
+}
+
+} // namespace Edit
+
 // Parsed edit (operator + motion/text-object, or single-key command)
 class ParsedEdit {
   // 0 -> no count, OK since it is impossible for 0 to be a count.
@@ -16,13 +34,21 @@ class ParsedEdit {
 
 public:
   std::string_view edit;  // The edit string (e.g., "x", "dd", "ciw", "dfa")
+  size_t id;              // Edit::hash(edit), so applying it doesn't rehash the string
 
-  ParsedEdit(std::string_view e, int c = 0) : edit(e), count(c) {}
+  ParsedEdit(std::string_view e, int c = 0) : edit(e), count(c), id(Edit::hash(e)) {}
 
   bool hasCount() const { return count != 0; }
   int effectiveCount() const { return count ? count : 1; }
 };
 
+// Outcome of a non-throwing edit
+enum class EditStatus : uint8_t {
+  Ok,        // Applied (or, from checkEdit, passed the prechecks)
+  NoEffect,  // Valid edit that would change nothing here (e.g. db at start of buffer)
+  Invalid,   // Not applicable here (unknown edit, wrong mode, not enough text)
+};
+
 // Edit operations that modify the buffer.
 // All functions modify lines and pos in place.
 namespace Edit {
@@ -57,4 +83,28 @@ void applyEdit(Lines& lines, Position& pos, Mode& mode,
                const NavContext& navContext,
                const ParsedEdit& edit);
 
+// Cheap precondition checks covering the cases where applyEdit would throw
+// before doing any work. Reads only the cursor line, so callers can reject an
+// edit before copying the buffer. Ok means applyEdit is expected to succeed.
+EditStatus checkEdit(const Lines& lines, const Position& pos, Mode mode,
+                     const ParsedEdit& edit);
+
+// Non-throwing applyEdit for search loops. Runs checkEdit first; on anything
+// but Ok, lines, pos and mode are left as they were.
+EditStatus tryApplyEdit(Lines& lines, Position& pos, Mode& mode,
+                        const NavContext& navContext,
+                        const ParsedEdit& edit);
+
+// tryApplyEdit for an edit the caller already ran checkEdit on, at this
+// position and mode, and got Ok
+EditStatus applyCheckedEdit(Lines& lines, Position& pos, Mode& mode,
+                            const NavContext& navContext,
+                            const ParsedEdit& edit);
+
+// Applies `edit` if it is a buffer-preserving navigation command (j, w, $, ...)
+// in Normal mode, and returns true. Returns false for anything else.
+// Throws like applyEdit when the navigation is invalid.
+bool applyNavigation(const Lines& lines, Position& pos, Mode mode,
+                     const ParsedEdit& edit);
+
 } // namespace Edit
@@ -0,0 +1,98 @@
+#include "LandingIndex.h"
+
+#include <algorithm>
+
+#include "VimCore/VimMovementUtils.h"
+
+using namespace std;
+
+namespace {
+
+bool isForward(CountedMotion motion) {
+  switch (motion) {
+    case CountedMotion::WordNext:
+    case CountedMotion::WordEndNext:
+    case CountedMotion::BigWordNext:
+    case CountedMotion::BigWordEndNext:
+    case CountedMotion::ParagraphNext:
+    case CountedMotion::SentenceNext:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+bool LandingIndex::indexed(CountedMotion motion) {
+  return motion != CountedMotion::ParagraphPrev && motion != CountedMotion::SentenceNext;
+}
+
+void LandingIndex::step(CountedMotion motion, Position& pos, const vector<string>& lines) {
+  switch (motion) {
+    case CountedMotion::WordNext:       VimMovementUtils::motionW(pos, lines, false); break;
+    case CountedMotion::WordPrev:       VimMovementUtils::motionB(pos, lines, false); break;
+    case CountedMotion::WordEndNext:    VimMovementUtils::motionE(pos, lines, false); break;
+    case CountedMotion::WordEndPrev:    VimMovementUtils::motionGe(pos, lines, false); break;
+    case CountedMotion::BigWordNext:    VimMovementUtils::motionW(pos, lines, true); break;
+    case CountedMotion::BigWordPrev:    VimMovementUtils::motionB(pos, lines, true); break;
+    case CountedMotion::BigWordEndNext: VimMovementUtils::motionE(pos, lines, true); break;
+    case CountedMotion::BigWordEndPrev: VimMovementUtils::motionGe(pos, lines, true); break;
+    case CountedMotion::ParagraphNext:  VimMovementUtils::motionParagraphNext(pos, lines); break;
+    case CountedMotion::ParagraphPrev:  VimMovementUtils::motionParagraphPrev(pos, lines); break;
+    case CountedMotion::SentenceNext:   VimMovementUtils::motionSentenceNext(pos, lines); break;
+    case CountedMotion::SentencePrev:   VimMovementUtils::motionSentencePrev(pos, lines); break;
+    case CountedMotion::COUNT: break;
+  }
+}
+
+LandingIndex::LandingIndex(const vector<string>& lines) {
+  if (lines.empty()) return;
+
+  int last = static_cast<int>(lines.size()) - 1;
+  Position first(0, 0);
+  Position end(last, max(0, static_cast<int>(lines[last].size()) - 1));
+
+  for (size_t m = 0; m < chains_.size(); m++) {
+    CountedMotion motion = static_cast<CountedMotion>(m);
+    Chain& chain = chains_[m];
+    chain.forward = isForward(motion);
+    if (!indexed(motion)) continue;
+
+    Position cur = chain.forward ? first : end;
+    while (true) {
+      Position next = cur;
+      step(motion, next, lines);
+      bool progressed = chain.forward ? next > cur : next < cur;
+      if (!progressed) {
+        chain.stopsAtEnd = !chain.stops.empty() && next == cur;
+        break;
+      }
+      chain.stops.push_back(next);
+      cur = next;
+    }
+  }
+}
+
+optional<Position> LandingIndex::advance(CountedMotion motion, const Position& pos, int count) const {
+  const Chain& chain = chains_[static_cast<size_t>(motion)];
+  if (count <= 0) return pos;
+
+  // First stop past pos in the motion's direction
+  auto next = chain.forward
+    ? upper_bound(chain.stops.begin(), chain.stops.end(), pos)
+    : partition_point(chain.stops.begin(), chain.stops.end(),
+                      [&](const Position& stop) { return !(stop < pos); });
+  if (next == chain.stops.end()) {
+    return nullopt;
+  }
+
+  size_t rank = static_cast<size_t>(next - chain.stops.begin()) + static_cast<size_t>(count) - 1;
+  if (rank >= chain.stops.size()) {
+    if (!chain.stopsAtEnd) {
+      return nullopt;
+    }
+    rank = chain.stops.size() - 1;
+  }
+  return chain.stops[rank];
+}
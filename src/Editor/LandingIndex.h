@@ -0,0 +1,66 @@
+// LandingIndex.h - Where counted word/paragraph/sentence motions land
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Position.h"
+
+// Motions whose {count} repeats the same step
+enum class CountedMotion : uint8_t {
+  WordNext,           // w
+  WordPrev,           // b
+  WordEndNext,        // e
+  WordEndPrev,        // ge
+  BigWordNext,        // W
+  BigWordPrev,        // B
+  BigWordEndNext,     // E
+  BigWordEndPrev,     // gE
+  ParagraphNext,      // }
+  ParagraphPrev,      // {
+  SentenceNext,       // )
+  SentencePrev,       // (
+  COUNT
+};
+
+// Each motion's landing positions in one buffer, in the order the motion
+// visits them. They are found by stepping the motion itself from the first
+// (or, backward, the last) position until it stops making progress, so they
+// carry the motion's exact end-of-buffer and empty-line behaviour.
+//
+// A step from any position lands on the next landing past it, so {count}
+// steps are one rank lookup plus count. Positions the chain can't answer
+// (past its last landing, or a count running into a motion that doesn't
+// stop in place at the buffer's end) are left to the caller's loop.
+//
+// { and ) don't have that property: { from a blank line skips the landing
+// at its own start, and ) stays put when no sentence end follows even if
+// a later landing exists. They always take the loop.
+class LandingIndex {
+  struct Chain {
+    std::vector<Position> stops;  // visiting order
+    bool forward = true;
+    bool stopsAtEnd = false;      // stepping the last stop leaves it in place
+  };
+
+  std::array<Chain, static_cast<size_t>(CountedMotion::COUNT)> chains_;
+
+public:
+  explicit LandingIndex(const std::vector<std::string>& lines);
+
+  // Position after `count` steps of `motion` from pos, before any clamping
+  // the caller applies after its own loop; nullopt if the index can't tell
+  std::optional<Position> advance(CountedMotion motion, const Position& pos, int count) const;
+
+  // Whether advance() can answer `motion` at all
+  static bool indexed(CountedMotion motion);
+
+  // A single step of `motion`, as applyParsedMotion loops over it
+  static void step(CountedMotion motion, Position& pos, const std::vector<std::string>& lines);
+
+  // Debug
+  size_t size(CountedMotion motion) const { return chains_[static_cast<size_t>(motion)].stops.size(); }
+};
@@ -84,6 +84,19 @@ std::vector<ParsedMotion> parseMotions(const std::string &seq) {
   return result;
 }
 
+// Takes `count` steps of a counted motion: one lookup when a landing index
+// can answer, the plain loop otherwise.
+static void repeatMotion(Position& pos, CountedMotion motion, int count,
+                         const std::vector<std::string>& lines, const LandingIndex* landings) {
+  if (landings && count > 1) {
+    if (std::optional<Position> landed = landings->advance(motion, pos, count)) {
+      pos = *landed;
+      return;
+    }
+  }
+  for(int i = 0; i < count; i++) LandingIndex::step(motion, pos, lines);
+}
+
 /*
  * Maintain this list of currently defined motions:
  * Alphabet:
@@ -102,12 +115,13 @@ std::vector<ParsedMotion> parseMotions(const std::string &seq) {
  * {}, (), ;,
  */
 // Directly modifies the position and mode passed in. 
-// We may think of passing in BufferIndex to improve simulating certain count motions.
-// However, I am not sure if it is worth it, as count > 1 is called only in simulateMotion(). It is helpful to compare vs repeated applications as well.
+// Counted word/paragraph/sentence motions use `landings` when given; it must
+// be built from `lines`.
 void applyParsedMotion(Position& pos, Mode& mode,
                        const NavContext& navContext,
                   const ParsedMotion& parsedMotion,
-                  const std::vector<std::string> &lines) {
+                  const std::vector<std::string> &lines,
+                  const LandingIndex* landings) {
   int n = static_cast<int>(lines.size());
   std::string_view motion = parsedMotion.motion;
   bool hasCount = parsedMotion.hasCount();
@@ -149,37 +163,36 @@ void applyParsedMotion(Position& pos, Mode& mode,
   // Words
   // Note: motionW/motionE may return "past end" positions for delete operations.
   // For cursor movement, clamp to valid bounds.
-  // TODO: Able to process faster with indices? Or at least modify underlying VimUtils calls to be more efficient with multiple invocations.
   else if (motion == "w") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionW(pos, lines, false);
+    repeatMotion(pos, CountedMotion::WordNext, count, lines, landings);
     pos.setCol(VimMovementUtils::clampCol(lines, pos.col, pos.line));
   } else if (motion == "b") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionB(pos, lines, false);
+    repeatMotion(pos, CountedMotion::WordPrev, count, lines, landings);
   } else if (motion == "e") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionE(pos, lines, false);
+    repeatMotion(pos, CountedMotion::WordEndNext, count, lines, landings);
     pos.setCol(VimMovementUtils::clampCol(lines, pos.col, pos.line));
   } else if (motion == "W") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionW(pos, lines, true);
+    repeatMotion(pos, CountedMotion::BigWordNext, count, lines, landings);
     pos.setCol(VimMovementUtils::clampCol(lines, pos.col, pos.line));
   } else if (motion == "B") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionB(pos, lines, true);
+    repeatMotion(pos, CountedMotion::BigWordPrev, count, lines, landings);
   } else if (motion == "E") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionE(pos, lines, true);
+    repeatMotion(pos, CountedMotion::BigWordEndNext, count, lines, landings);
     pos.setCol(VimMovementUtils::clampCol(lines, pos.col, pos.line));
   } else if (motion == "ge") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionGe(pos, lines, false);
+    repeatMotion(pos, CountedMotion::WordEndPrev, count, lines, landings);
   } else if (motion == "gE") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionGe(pos, lines, true);
+    repeatMotion(pos, CountedMotion::BigWordEndPrev, count, lines, landings);
   }
   // Text object jumps
   else if (motion == "{") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionParagraphPrev(pos, lines);
+    repeatMotion(pos, CountedMotion::ParagraphPrev, count, lines, landings);
   } else if (motion == "}") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionParagraphNext(pos, lines);
+    repeatMotion(pos, CountedMotion::ParagraphNext, count, lines, landings);
   } else if (motion == "(") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionSentencePrev(pos, lines);
+    repeatMotion(pos, CountedMotion::SentencePrev, count, lines, landings);
   } else if (motion == ")") {
-    for(int i = 0; i < count; i++) VimMovementUtils::motionSentenceNext(pos, lines);
+    repeatMotion(pos, CountedMotion::SentenceNext, count, lines, landings);
   }
   // f/F/t/T motions with optional ;/, repeats (e.g., "fa;;", "Ta,")
   else if (motion.size() >= 2 && (motion[0] == 'f' || motion[0] == 'F' ||
@@ -247,10 +260,11 @@ void applySingleMotion(Position& pos, Mode& mode, const NavContext& navContext,
 // Important that pos and mode are passed by copy! We wouldn't want to change any state.
 MotionResult simulateMotions(Position pos, Mode mode, const NavContext& navContext,
                           const std::string &motionSeq,
-                          const std::vector<std::string> &lines) {
+                          const std::vector<std::string> &lines,
+                          const LandingIndex* landings) {
   auto motions = parseMotions(motionSeq);
   for (const auto &motion : motions) {
-    applyParsedMotion(pos, mode, navContext, motion, lines);
+    applyParsedMotion(pos, mode, navContext, motion, lines, landings);
   }
   return MotionResult(pos, mode);
 }
@@ -6,6 +6,7 @@
 #include <vector>
 #include <iostream>
 
+#include "LandingIndex.h"
 #include "Position.h"
 #include "Mode.h"
 #include "NavContext.h"
@@ -44,9 +45,12 @@ std::ostream& operator<<(std::ostream& os, const ParsedMotion& motion);
 // Parse a motion sequence into individual ParsedMotion tokens
 std::vector<ParsedMotion> parseMotions(const std::string& seq);
 
+// `landings`, if given, must be built from `lines`; counted word, paragraph
+// and sentence motions then skip their step loop.
 void applyParsedMotion(Position& pos, Mode& mode, const NavContext& navContext,
                   const ParsedMotion& motion,
-                  const std::vector<std::string> &lines);
+                  const std::vector<std::string> &lines,
+                  const LandingIndex* landings = nullptr);
 
 // Currently only to be externally called in State::applyMotion.
 void applySingleMotion(Position& pos, Mode& mode, const NavContext& navContext,
@@ -56,5 +60,6 @@ void applySingleMotion(Position& pos, Mode& mode, const NavContext& navContext,
 // Parses the motion sequence, and returns the result if they are applied to the current state
 MotionResult simulateMotions(Position pos, Mode mode, const NavContext& navContext,
                           const std::string& motionSeq,
-                          const std::vector<std::string>& lines);
+                          const std::vector<std::string>& lines,
+                          const LandingIndex* landings = nullptr);
 
@@ -3,100 +3,313 @@
 #include "DiffState.h"
 #include "EditOptimizer.h"
 #include "MovementOptimizer.h"
+#include "ResultCache.h"
 
 #include "State/CompositionState.h"
 #include "State/MotionState.h"
 #include "Keyboard/MotionToKeys.h"
 #include "Utils/Lines.h"
 #include "Utils/Debug.h"
+#include "Utils/MpscQueue.h"
+#include "Utils/TaskScheduler.h"
+#include "Utils/VersionedLines.h"
 
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <exception>
 #include <functional>
 #include <algorithm>
+#include <limits>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
-vector<Result> CompositionOptimizer::optimize(
-  const vector<string>& startLines,
-  const Position startPos,
-  const vector<string>& endLines,
-  const Position endPos,
-  const string& userSequence,
-  const NavContext& navigationContext,
-  const ImpliedExclusions& impliedExclusions,
-  const MotionToKeys& rawMotionToKeys,
-  const optional<OptimizerParams>& paramsOverride
-) {
-  // Merge defaults with overrides
-  const OptimizerParams params = OptimizerParams::merge(defaultParams, paramsOverride);
-
-  // Ensures proper hashing later, and 10 is buffer in case we insert more text, then delete
-  for(const string& s : startLines) { assert(s.size() < static_cast<size_t>(maxLineLength-10)); }
-  for(const string& s : endLines) { assert(s.size() < static_cast<size_t>(maxLineLength-10)); }
+namespace {
+
+// A range sub-search depends on the buffer version (editsCompleted), the start
+// position and the typing context of the effort it continues; the effort
+// itself only shifts every result by the same amount.
+struct SubSearchKey {
+  int editsCompleted;
+  int line;
+  int col;
+  int targetCol;
+  uint32_t typingContext;
+
+  bool operator==(const SubSearchKey& other) const = default;
+};
+
+struct SubSearchKeyHash {
+  size_t operator()(const SubSearchKey& k) const {
+    size_t h = k.typingContext;
+    for (int v : {k.editsCompleted, k.line, k.col, k.targetCol}) {
+      h ^= hash<int>{}(v) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+  }
+};
+
+// Everything an optimize() call's expansions read, fixed once the diff is known
+struct SearchInputs {
+  const OptimizerParams& params;
+  const vector<DiffState>& diffStates;
+  const EditRegionIndex& regionIndex;
+  const VersionedLines& linesAfterNEdits;
+  const NavContext& navigationContext;
+  const ImpliedExclusions& impliedExclusions;
+  const MotionToKeys& motionToKeys;
+  const string& userSequence;
+  double userEffort;
+
+  int totalEdits() const { return static_cast<int>(diffStates.size()); }
+};
+
+// Edit regions solved so far. Regions with the same EditResultKey share one
+// slot, and each slot is solved once, by whichever thread claims it first;
+// a search thread reaching a slot claimed elsewhere waits for that solve.
+// With params.threads > 1, tasks on the shared scheduler also claim slots in
+// search order, so regions ahead of the search are solved in parallel.
+class SolvedRegions {
+  enum { UNSOLVED, SOLVING, SOLVED };
+
+  struct Slot {
+    atomic<int> state{UNSOLVED};
+    SharedEditResult result;
+    exception_ptr error;
+  };
 
-  MotionToKeys motionToKeys = rawMotionToKeys;
-  if(impliedExclusions.exclude_G) {
-    motionToKeys.erase("G");
+  CompositionOptimizer& optimizer;
+  const SearchInputs& in;
+  vector<int> sameAs;        // first region with the same key, per region
+  vector<int> distinct;      // regions that own a slot, in search order
+  vector<Slot> slots;
+  mutex solvedMutex;
+  condition_variable solvedCv;
+  atomic<size_t> nextPrefetch{0};
+  TaskGroup prefetch;        // last, so its tasks finish before the slots go
+
+  bool claim(int i) {
+    int expected = UNSOLVED;
+    return slots[i].state.compare_exchange_strong(expected, SOLVING);
   }
-  if(impliedExclusions.exclude_gg) {
-    motionToKeys.erase("gg");
+
+  void solve(int i) {
+    Slot& slot = slots[i];
+    try {
+      slot.result = optimizer.solveEditRegion(in.diffStates[i], in.params);
+    } catch (...) {
+      slot.error = current_exception();
+    }
+    {
+      lock_guard lock(solvedMutex);
+      slot.state = SOLVED;
+    }
+    solvedCv.notify_all();
   }
 
-  // Get minimal diff between start and end buffers
-  vector<DiffState> rawDiffs = Myers::calculate(
-      Lines(startLines.begin(), startLines.end()),
-      Lines(endLines.begin(), endLines.end()));
+public:
+  SolvedRegions(CompositionOptimizer& optimizer, const SearchInputs& in)
+      : optimizer(optimizer), in(in), sameAs(in.totalEdits()), slots(in.totalEdits()) {
+    uint64_t configHash = hashConfig(optimizer.config);
+    unordered_map<EditResultKey, int, EditResultKeyHash> first;
+    for (int i = 0; i < in.totalEdits(); i++) {
+      auto [it, inserted] = first.emplace(EditResultKey(in.diffStates[i], configHash), i);
+      sameAs[i] = it->second;
+      if (inserted) {
+        distinct.push_back(i);
+      }
+    }
 
-  // If no edits needed, return empty (nothing to optimize)
-  if (rawDiffs.empty()) {
-    return {};
+    size_t helpers = min<size_t>(max(in.params.threads, 1) - 1, distinct.size());
+    for (size_t t = 0; t < helpers; t++) {
+      prefetch.run([this] {
+        size_t k;
+        while (!prefetch.isCancelled()
+               && (k = nextPrefetch.fetch_add(1, memory_order_relaxed)) < distinct.size()) {
+          if (claim(distinct[k])) {
+            solve(distinct[k]);
+          }
+        }
+      });
+    }
   }
 
-  // Determine processing direction based on start position relative to edits.
-  // Forward = process edits left->right (top->bottom)
-  // Backward = process edits right->left (bottom->top)
-  // If backward, we reverse the edit order so all subsequent logic is uniform.
-  double distToFirst = costToGoal(startPos, rawDiffs.front().posBegin);
-  double distToLast = costToGoal(startPos, rawDiffs.back().posEnd);
-  bool forward = (distToFirst <= distToLast + forwardBias);
+  // Regions still queued are skipped; one being solved is waited for
+  ~SolvedRegions() { prefetch.cancel(); }
 
-  if (!forward) {
-    std::reverse(rawDiffs.begin(), rawDiffs.end());
-    debug("Processing edits in reverse order (backward)");
+  SharedEditResult get(int i) {
+    Slot& slot = slots[sameAs[i]];
+    if (claim(sameAs[i])) {
+      solve(sameAs[i]);
+    } else if (slot.state.load() != SOLVED) {
+      unique_lock lock(solvedMutex);
+      solvedCv.wait(lock, [&] { return slot.state.load() == SOLVED; });
+    }
+    if (slot.error) {
+      rethrow_exception(slot.error);
+    }
+    return slot.result;
+  }
+};
+
+// Generates successors of composition states. One per search thread: it owns
+// the heuristic built from the regions this thread has seen solved, its
+// movement sub-search memo, and a copy of the buffer versions (materializing
+// a version updates their cache).
+class Expander {
+  const CompositionOptimizer& optimizer;
+  const SearchInputs& in;
+  SolvedRegions& regions;
+  VersionedLines linesAfterNEdits;
+
+  // Unsolved regions (null results) count with a lower bound until reached
+  vector<SharedEditResult> editResults;
+  vector<double> suffixEditCosts;
+
+  // Movement sub-searches, shared by every expansion that repeats one
+  MovementOptimizer movementOptimizer;
+  unordered_map<SubSearchKey, vector<RangeResult>, SubSearchKeyHash> subSearches;
+
+public:
+  Expander(const CompositionOptimizer& optimizer, const SearchInputs& in, SolvedRegions& regions)
+      : optimizer(optimizer), in(in), regions(regions),
+        linesAfterNEdits(in.linesAfterNEdits),
+        editResults(in.totalEdits()),
+        suffixEditCosts(optimizer.computeSuffixEditCosts(editResults, in.diffStates)),
+        movementOptimizer(optimizer.config) {}
+
+  double heuristic(const CompositionState& s) const {
+    return optimizer.heuristic(s, s.getEditsCompleted(), suffixEditCosts, in.diffStates, in.params);
   }
 
-  // Adjust indices for sequential application, so edit 2's indices are in buffer after edit 1 is applied
-  vector<DiffState> diffStates = Myers::adjustForSequential(rawDiffs);
-
-  int totalEdits = static_cast<int>(diffStates.size());
+  // Calls emit(CompositionState&&) for every successor of s, costs updated
+  template <typename Emit>
+  void expand(const CompositionState& s, Emit&& emit);
+
+  // Takes over the movement sub-searches another thread solved
+  void adoptSubSearches(Expander& other) { subSearches.merge(other.subSearches); }
+};
+
+template <typename Emit>
+void Expander::expand(const CompositionState& s, Emit&& emit) {
+  const Config& config = optimizer.config;
+  Position pos = s.getPos();
+  int editsCompleted = s.getEditsCompleted();
+  Mode mode = s.getMode();
+
+  // Current buffer size; the buffer itself is only built for movement searches
+  int numLines = linesAfterNEdits.lineCount(editsCompleted);
+
+  // ========== EDIT TRANSITIONS ==========
+  // Check if we can perform the next edit from current position
+  if (mode == Mode::Normal) {
+    // Check if next edit (editsCompleted) covers this position
+    if (in.regionIndex.contains(pos, editsCompleted)) {
+      const DiffState& diff = in.diffStates[editsCompleted];
+      if (!editResults[editsCompleted]) {
+        editResults[editsCompleted] = regions.get(editsCompleted);
+        suffixEditCosts = optimizer.computeSuffixEditCosts(editResults, in.diffStates);
+      }
+      const EditResult& editResult = *editResults[editsCompleted];
+
+      // Convert buffer position to edit region index
+      int i = optimizer.bufferPosToEditIndex(pos, diff);
+      if (i >= 0 && i < editResult.n) {
+        // Try all possible ending positions
+        for (int j = 0; j < editResult.m; j++) {
+          const Result& editRes = editResult.adj[i][j];
+          if (editRes.isValid()) {
+            CompositionState newState = s;
+
+            // Convert end index back to buffer position
+            // NOTE: After this edit, we're in linesAfterNEdits[editsCompleted + 1]
+            Position newPos = optimizer.editIndexToBufferPos(j, diff);
+
+            // Edit results always end in Normal mode (Esc at the end)
+            newState.applyEditTransition(editRes, newPos, Mode::Normal, config);
+            newState.updateCost(heuristic(newState));
+            emit(std::move(newState));
+          }
+        }
+      }
+    }
+  }
 
-  // Build intermediate buffer states. [0] = no changes (same as startLines), [d] = all changes (same as endLines)
-  vector<Lines> linesAfterNEdits = calculateLinesAfterDiffs(
-      Lines(startLines.begin(), startLines.end()), diffStates, totalEdits);
+  // ========== MOVEMENT TRANSITIONS ==========
+  // Use MovementOptimizer to find optimal paths to next edit region
+  if (editsCompleted < in.totalEdits()) {
+    const DiffState& nextEdit = in.diffStates[editsCompleted];
+
+    // Copy NavContext for motion application
+    NavContext navContext = in.navigationContext;
+
+    // Compute exclusions for this sub-search:
+    // - Inherit parent exclusions
+    // - Additionally exclude gg if target range doesn't include line 0
+    // - Additionally exclude G if target range doesn't include last line
+    int lastLine = numLines - 1;
+    ImpliedExclusions subExclusions(
+      in.impliedExclusions.exclude_G || nextEdit.posEnd.line < lastLine,
+      in.impliedExclusions.exclude_gg || nextEdit.posBegin.line > 0
+    );
 
-  vector<EditResult> editResults = calculateEditResults(diffStates);
+    // Use MovementOptimizer to find optimal paths to any position in the edit region
+    // Pass only Position and RunningEffort - sub-search computes its own effort/cost fresh
+    // States reaching the same position with the same typing context reuse
+    // one sub-search: its cutoff counts only the movement's own effort, and the
+    // results are applied by replaying their keys, so their keyCost is not used.
+    const RunningEffort& runningEffort = s.getRunningEffort();
+    SubSearchKey subKey{editsCompleted, pos.line, pos.col, pos.targetCol, runningEffort.typingContext()};
+    auto memo = subSearches.find(subKey);
+    if (memo == subSearches.end() || !optimizer.memoizeSubSearches) {
+      SharedLines currentLines = linesAfterNEdits.lines(editsCompleted);
+      OptimizerParams subParams(clamp(nextEdit.origCharCount(), 1, 10));  // Max results per movement search
+      subParams.cancel = in.params.cancel;
+      vector<RangeResult> found = movementOptimizer.optimizeToRange(
+        *currentLines,
+        pos,
+        runningEffort,
+        nextEdit.posBegin,
+        nextEdit.posEnd,
+        in.userSequence,
+        navContext,
+        false, // allowMultiplePerPosition: only need 1 best path per position
+        subExclusions,
+        in.motionToKeys,
+        subParams
+      );
+      memo = subSearches.insert_or_assign(subKey, std::move(found)).first;
+    }
 
-  // Compute suffix sums of min edit costs for O(1) heuristic lookup
-  vector<double> suffixEditCosts = computeSuffixEditCosts(editResults);
+    // Create new CompositionStates from movement results
+    for (const RangeResult& movResult : memo->second) {
+      if (!movResult.isValid()) continue;
 
-  // Position -> editIndex map
-  int maxLineSize = 0;
-  for (const auto& lines : linesAfterNEdits) {
-    maxLineSize = max(maxLineSize, static_cast<int>(lines.size()));
+      CompositionState newState = s;
+      newState.applyMovementResult(movResult, config);
+      newState.updateCost(heuristic(newState));
+      emit(std::move(newState));
+    }
   }
-  int maxPosKey = maxLineSize * maxLineLength;
-  vector<vector<int>> posToEditIndex = buildPosToEditIndex(diffStates, maxPosKey);
+}
 
+using OpenList = priority_queue<CompositionState, vector<CompositionState>, greater<CompositionState>>;
+using CostMap = unordered_map<CompositionStateKey, double, CompositionStateKeyHash>;
+
+vector<Result> searchSequential(const CompositionOptimizer& optimizer, const SearchInputs& in,
+                                Expander& expander, const Position startPos) {
+  const OptimizerParams& params = in.params;
+  int totalEdits = in.totalEdits();
   int totalExplored = 0;
-  double userEffort = getEffort(userSequence, config);
 
   vector<Result> res;
-  unordered_map<CompositionStateKey, double, CompositionStateKeyHash> costMap;
-
-  priority_queue<CompositionState, vector<CompositionState>, greater<CompositionState>> pq;
+  CostMap costMap;
+  OpenList pq;
 
-  auto exploreNewState = [this, &pq, &costMap, &userEffort, totalEdits, &params](CompositionState&& newState) {
-    if(newState.getEffort() > userEffort * params.exploreFactor) {
+  auto exploreNewState = [&pq, &costMap, &in, totalEdits, &params](CompositionState&& newState) {
+    if(newState.getEffort() > in.userEffort * params.exploreFactor) {
       return;
     }
     double newCost = newState.getCost();
@@ -117,7 +330,7 @@ vector<Result> CompositionOptimizer::optimize(
 
   // Initialize starting state
   CompositionState startingState(startPos, Mode::Normal, 0);
-  startingState.updateCost(heuristic(startingState, 0, suffixEditCosts, diffStates, params));
+  startingState.updateCost(expander.heuristic(startingState));
   pq.push(startingState);
   costMap[startingState.getKey()] = startingState.getCost();
 
@@ -125,9 +338,12 @@ vector<Result> CompositionOptimizer::optimize(
   while(!pq.empty()) {
     CompositionState s = pq.top();
     pq.pop();
-    Position pos = s.getPos();
     int editsCompleted = s.getEditsCompleted();
-    Mode mode = s.getMode();
+
+    if(params.cancel.isCancelled()) {
+      debug("search cancelled");
+      break;
+    }
 
     if(++totalExplored > params.maxSearchDepth) {
       debug("maximum total explored count reached");
@@ -138,7 +354,7 @@ vector<Result> CompositionOptimizer::optimize(
     bool isGoal = (editsCompleted == totalEdits);
 
     if(isGoal) {
-      res.emplace_back(s.getMotionSequence(), s.getRunningEffort().getEffort(config));
+      res.emplace_back(s.getMotionSequence(), s.getRunningEffort().getEffort(optimizer.config));
       if(res.size() >= static_cast<size_t>(params.maxResults)) {
         debug("maximum result count reached");
         break;
@@ -149,123 +365,288 @@ vector<Result> CompositionOptimizer::optimize(
       continue;
     }
 
-    // Get current buffer state
-    const Lines& currentLines = linesAfterNEdits[editsCompleted];
-    int numLines = static_cast<int>(currentLines.size());
-
-    // ========== EDIT TRANSITIONS ==========
-    // Check if we can perform the next edit from current position
-    if (mode == Mode::Normal) {
-      int posKey = posToKey(pos);
-      if (posKey >= 0 && posKey < static_cast<int>(posToEditIndex.size())) {
-        const vector<int>& validEdits = posToEditIndex[posKey];
-        // Check if next edit (editsCompleted) is in the valid list
-        if (find(validEdits.begin(), validEdits.end(), editsCompleted) != validEdits.end()) {
-          const DiffState& diff = diffStates[editsCompleted];
-          const EditResult& editResult = editResults[editsCompleted];
-
-          // Convert buffer position to edit region index
-          int i = bufferPosToEditIndex(pos, diff);
-          if (i >= 0 && i < editResult.n) {
-            // Try all possible ending positions
-            for (int j = 0; j < editResult.m; j++) {
-              const Result& editRes = editResult.adj[i][j];
-              if (editRes.isValid()) {
-                CompositionState newState = s;
-
-                // Convert end index back to buffer position
-                // NOTE: After this edit, we're in linesAfterNEdits[editsCompleted + 1]
-                Position newPos = editIndexToBufferPos(j, diff);
-
-                // Edit results always end in Normal mode (Esc at the end)
-                newState.applyEditTransition(editRes.sequences, newPos, Mode::Normal, config);
-                newState.updateCost(heuristic(newState, editsCompleted + 1, suffixEditCosts, diffStates, params));
-                exploreNewState(std::move(newState));
-              }
-            }
-          }
-        }
+    expander.expand(s, exploreNewState);
+  }
+
+  return res;
+}
+
+// Hash-distributed A* (HDA*). Every state key has an owner thread, picked by
+// its hash; only the owner keeps the key's best cost and open-list entries.
+// Successors are sent to their owners through lock-free queues.
+//
+// The heuristic isn't admissible and goals pop in no global order, so which
+// goals this finds depends on timing. It only does the expensive part of the
+// search in parallel: once maxResults goals are known, states costing more
+// than the worst of them are dropped, and when it ends, the sequential search
+// runs over the movement sub-searches it solved and picks the results. The
+// parallel search ends when no state is queued, open or being expanded
+// anywhere: `inFlight` counts states from the moment they
+// are sent until their owner drops or finishes expanding them, and a parent
+// is only uncounted after its successors were, so it reads zero only once
+// the whole search is drained.
+vector<Result> searchDistributed(const CompositionOptimizer& optimizer, const SearchInputs& in,
+                                 SolvedRegions& regions, const Position startPos, int threads) {
+  const OptimizerParams& params = in.params;
+  int totalEdits = in.totalEdits();
+
+  struct Worker {
+    Expander expander;
+    OpenList open;
+    CostMap costMap;
+    MpscQueue<CompositionState> inbox;
+
+    Worker(const CompositionOptimizer& optimizer, const SearchInputs& in, SolvedRegions& regions)
+        : expander(optimizer, in, regions) {}
+  };
+  vector<unique_ptr<Worker>> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.push_back(make_unique<Worker>(optimizer, in, regions));
+  }
+
+  atomic<long> inFlight{0};
+  atomic<int> totalExplored{0};
+  atomic<bool> stop{false};
+
+  mutex goalMutex;
+  vector<double> goalCosts;  // guarded by goalMutex
+  atomic<double> bound{numeric_limits<double>::infinity()};
+
+  exception_ptr error;
+  mutex errorMutex;
+
+  auto ownerOf = [threads](const CompositionStateKey& key) {
+    // Mix first: the key hash's low bits follow the column closely
+    uint64_t h = CompositionStateKeyHash{}(key) * 0x9e3779b97f4a7c15ull;
+    return static_cast<size_t>((h >> 32) % static_cast<uint64_t>(threads));
+  };
+
+  auto send = [&](CompositionState&& newState) {
+    if (newState.getEffort() > in.userEffort * params.exploreFactor
+        || newState.getCost() > bound.load(memory_order_relaxed)) {
+      return;
+    }
+    inFlight.fetch_add(1);
+    workers[ownerOf(newState.getKey())]->inbox.push(std::move(newState));
+  };
+
+  auto receive = [&](Worker& w, CompositionState&& newState) {
+    double newCost = newState.getCost();
+    const CompositionStateKey newKey = newState.getKey();
+    auto it = w.costMap.find(newKey);
+    if (it == w.costMap.end()) {
+      // Don't cache goal states (we want multiple results)
+      if (newState.getEditsCompleted() != totalEdits) {
+        w.costMap.emplace(newKey, newCost);
       }
+      w.open.push(std::move(newState));
+    } else if (newCost <= it->second) {
+      it->second = newCost;
+      w.open.push(std::move(newState));
+    } else {
+      inFlight.fetch_sub(1);
     }
+  };
 
-    // ========== MOVEMENT TRANSITIONS ==========
-    // Use MovementOptimizer to find optimal paths to next edit region
-    if (editsCompleted < totalEdits) {
-      const DiffState& nextEdit = diffStates[editsCompleted];
-
-      // Copy NavContext for motion application
-      NavContext navContext = navigationContext;
-
-      // Compute exclusions for this sub-search:
-      // - Inherit parent exclusions
-      // - Additionally exclude gg if target range doesn't include line 0
-      // - Additionally exclude G if target range doesn't include last line
-      int lastLine = numLines - 1;
-      ImpliedExclusions subExclusions(
-        impliedExclusions.exclude_G || nextEdit.posEnd.line < lastLine,
-        impliedExclusions.exclude_gg || nextEdit.posBegin.line > 0
-      );
+  auto addGoal = [&](const CompositionState& s) {
+    lock_guard lock(goalMutex);
+    goalCosts.push_back(s.getCost());
+    size_t k = static_cast<size_t>(params.maxResults);
+    if (goalCosts.size() >= k) {
+      vector<double> costs = goalCosts;
+      nth_element(costs.begin(), costs.begin() + (k - 1), costs.end());
+      bound.store(costs[k - 1], memory_order_relaxed);
+    }
+  };
 
-      // Use MovementOptimizer to find optimal paths to any position in the edit region
-      // Pass only Position and RunningEffort - sub-search computes its own effort/cost fresh
-      // RangeResult.keyCost returns delta effort for this movement
-      MovementOptimizer movementOptimizer(config);
-      vector<RangeResult> movementResults = movementOptimizer.optimizeToRange(
-        currentLines,
-        pos,
-        s.getRunningEffort(),
-        nextEdit.posBegin,
-        nextEdit.posEnd,
-        "", // No user sequence reference for sub-optimization
-        navContext,
-        false, // allowMultiplePerPosition: only need 1 best path per position
-        subExclusions,
-        motionToKeys,
-        OptimizerParams(clamp(nextEdit.origCharCount(), 1, 10))  // Max results per movement search
-      );
+  // Pops and expands one state of w's open list
+  auto process = [&](Worker& w) {
+    CompositionState s = w.open.top();
+    w.open.pop();
 
-      // Create new CompositionStates from movement results
-      for (const RangeResult& movResult : movementResults) {
-        if (!movResult.isValid()) continue;
+    if (params.cancel.isCancelled()) {
+      debug("search cancelled");
+      stop = true;
+    } else if (totalExplored.fetch_add(1, memory_order_relaxed) >= params.maxSearchDepth) {
+      debug("maximum total explored count reached");
+      stop = true;
+    } else if (s.getCost() > bound.load(memory_order_relaxed)) {
+      // Can't make the best maxResults any more
+    } else if (s.getEditsCompleted() == totalEdits) {
+      addGoal(s);
+    } else {
+      auto it = w.costMap.find(s.getKey());
+      if (it == w.costMap.end() || it->second >= s.getCost()) {
+        w.expander.expand(s, send);
+      }
+    }
+    inFlight.fetch_sub(1);
+  };
 
-        CompositionState newState = s;
-        newState.applyMovementResult(movResult.sequences, movResult.endPos, config);
-        newState.updateCost(heuristic(newState, editsCompleted, suffixEditCosts, diffStates, params));
-        exploreNewState(std::move(newState));
+  auto work = [&](size_t t) {
+    Worker& w = *workers[t];
+    try {
+      while (!stop.load(memory_order_relaxed)) {
+        while (optional<CompositionState> msg = w.inbox.pop()) {
+          receive(w, std::move(*msg));
+        }
+        if (!w.open.empty()) {
+          process(w);
+        } else if (inFlight.load() == 0) {
+          break;
+        } else {
+          this_thread::yield();
+        }
       }
+    } catch (...) {
+      lock_guard lock(errorMutex);
+      if (!error) {
+        error = current_exception();
+      }
+      stop = true;
     }
+  };
+
+  CompositionState startingState(startPos, Mode::Normal, 0);
+  startingState.updateCost(workers[0]->expander.heuristic(startingState));
+  send(std::move(startingState));
+
+  // Helper threads' debug output is appended to this thread's once they end
+  vector<string> helperOutput(threads);
+  {
+    vector<jthread> helpers;
+    for (int t = 1; t < threads; t++) {
+      helpers.emplace_back([&, t] {
+        work(t);
+        helperOutput[t] = dout().str();
+      });
+    }
+    work(0);
+  }  // joins
+  for (const string& output : helperOutput) {
+    dout() << output;
   }
 
-  return res;
+  if (error) {
+    rethrow_exception(error);
+  }
+
+  // A fresh expander, so the heuristic evolves as it does in a sequential run
+  Expander expander(optimizer, in, regions);
+  for (unique_ptr<Worker>& w : workers) {
+    expander.adoptSubSearches(w->expander);
+  }
+  return searchSequential(optimizer, in, expander, startPos);
 }
 
-vector<double> CompositionOptimizer::computeSuffixEditCosts(const vector<EditResult>& editResults) const {
-  int n = static_cast<int>(editResults.size());
-  vector<double> suffixCosts(n + 1, 0.0);
+} // namespace
 
-  // Compute median cost for each edit, then build suffix sums.
+vector<Result> CompositionOptimizer::optimize(
+  const vector<string>& startLines,
+  const Position startPos,
+  const vector<string>& endLines,
+  const Position endPos,
+  const string& userSequence,
+  const NavContext& navigationContext,
+  const ImpliedExclusions& impliedExclusions,
+  const MotionToKeys& rawMotionToKeys,
+  const optional<OptimizerParams>& paramsOverride
+) {
+  // Merge defaults with overrides
+  const OptimizerParams params = OptimizerParams::merge(defaultParams, paramsOverride);
+
+  MotionToKeys motionToKeys = rawMotionToKeys;
+  if(impliedExclusions.exclude_G) {
+    motionToKeys.erase("G");
+  }
+  if(impliedExclusions.exclude_gg) {
+    motionToKeys.erase("gg");
+  }
+
+  // Get minimal diff between start and end buffers
+  vector<DiffState> rawDiffs = Myers::calculate(
+      Lines(startLines.begin(), startLines.end()),
+      Lines(endLines.begin(), endLines.end()));
+
+  // If no edits needed, return empty (nothing to optimize)
+  if (rawDiffs.empty()) {
+    return {};
+  }
+
+  // Determine processing direction based on start position relative to edits.
+  // Forward = process edits left->right (top->bottom)
+  // Backward = process edits right->left (bottom->top)
+  // If backward, we reverse the edit order so all subsequent logic is uniform.
+  double distToFirst = costToGoal(startPos, rawDiffs.front().posBegin);
+  double distToLast = costToGoal(startPos, rawDiffs.back().posEnd);
+  bool forward = (distToFirst <= distToLast + forwardBias);
+
+  if (!forward) {
+    std::reverse(rawDiffs.begin(), rawDiffs.end());
+    debug("Processing edits in reverse order (backward)");
+  }
+
+  // Adjust indices for sequential application, so edit 2's indices are in buffer after edit 1 is applied
+  vector<DiffState> diffStates = Myers::adjustForSequential(rawDiffs);
+
+  int totalEdits = static_cast<int>(diffStates.size());
+
+  // Build intermediate buffer states. [0] = no changes (same as startLines), [d] = all changes (same as endLines)
+  VersionedLines linesAfterNEdits = calculateLinesAfterDiffs(
+      Lines(startLines.begin(), startLines.end()), diffStates, totalEdits);
+
+  // Which edit regions can be started from a position
+  EditRegionIndex regionIndex(diffStates);
+
+  SearchInputs inputs{params, diffStates, regionIndex, linesAfterNEdits, navigationContext,
+                      impliedExclusions, motionToKeys, userSequence, getEffort(userSequence, config)};
+
+  // Edit regions are solved when the search first reaches them, or ahead of
+  // it on the scheduler; until then the heuristic uses a lower bound
+  SolvedRegions regions(*this, inputs);
+
+  if (params.searchThreads > 1) {
+    return searchDistributed(*this, inputs, regions, startPos, params.searchThreads);
+  }
+  Expander expander(*this, inputs, regions);
+  return searchSequential(*this, inputs, expander, startPos);
+}
+
+double CompositionOptimizer::editCostEstimate(const EditResult& editRes) const {
+  // Median cost of the region's valid entries.
   // Using median is good for not being biased with large outliers.
   // How much cheaper the best edit costs are from this median is a good measure of desired exploredness
-  for (int i = n - 1; i >= 0; i--) {
-    const auto& editRes = editResults[i];
-    vector<double> costs;
-    for (int j = 0; j < editRes.n; j++) {
-      for (int k = 0; k < editRes.m; k++) {
-        if (editRes.adj[j][k].isValid()) {
-          costs.push_back(editRes.adj[j][k].keyCost);
-        }
+  vector<double> costs;
+  for (int j = 0; j < editRes.n; j++) {
+    for (int k = 0; k < editRes.m; k++) {
+      if (editRes.adj[j][k].isValid()) {
+        costs.push_back(editRes.adj[j][k].keyCost);
       }
     }
+  }
 
-    double medianCost;
-    if (costs.empty()) {
-      medianCost = 100.0;
-    } else {
-      size_t mid = costs.size() / 2;
-      nth_element(costs.begin(), costs.begin() + mid, costs.end());
-      medianCost = costs[mid];
-    }
-    suffixCosts[i] = suffixCosts[i + 1] + medianCost;
+  if (costs.empty()) {
+    return 100.0;
+  }
+  size_t mid = costs.size() / 2;
+  nth_element(costs.begin(), costs.begin() + mid, costs.end());
+  return costs[mid];
+}
+
+double CompositionOptimizer::editCostLowerBound(const DiffState& diff) const {
+  // Every inserted character takes a key, and any change takes at least one
+  return max(1, diff.newCharCount());
+}
+
+vector<double> CompositionOptimizer::computeSuffixEditCosts(const vector<SharedEditResult>& editResults,
+                                                            const vector<DiffState>& diffStates) const {
+  int n = static_cast<int>(editResults.size());
+  vector<double> suffixCosts(n + 1, 0.0);
+
+  for (int i = n - 1; i >= 0; i--) {
+    double cost = editResults[i] ? editCostEstimate(*editResults[i])
+                                 : editCostLowerBound(diffStates[i]);
+    suffixCosts[i] = suffixCosts[i + 1] + cost;
   }
 
   return suffixCosts;
@@ -308,51 +689,37 @@ double CompositionOptimizer::heuristic(const CompositionState& s, int editsCompl
 
 int CompositionOptimizer::bufferPosToEditIndex(const Position& bufferPos, const DiffState& diff) const {
   // Convert buffer position to flat index within deletedLines
-  Lines deleted = diff.deletedLines();
   int editLine = bufferPos.line - diff.origLineStart();
 
-  if (editLine < 0 || editLine >= static_cast<int>(deleted.size())) {
+  if (editLine < 0 || editLine >= diff.origLineCount()) {
     return -1;
   }
 
-  // Compute flat index: sum of previous line lengths + column
-  // For character-level diffs, we need to account for the column offset within the first line
-  int flatIndex = 0;
-
-  // If this is a mid-line diff, adjust for the starting column
+  // For character-level diffs, the first line of the region is relative to posBegin.col
   if (editLine == 0) {
-    // First line of edit region: column is relative to posBegin.col
-    flatIndex = bufferPos.col - diff.posBegin.col;
-    if (flatIndex < 0) return -1;
-  } else {
-    // Not first line: sum previous line lengths + current column
-    for (int i = 0; i < editLine; i++) {
-      flatIndex += static_cast<int>(deleted[i].size());
-    }
-    flatIndex += bufferPos.col;
+    int flatIndex = bufferPos.col - diff.posBegin.col;
+    return flatIndex < 0 ? -1 : flatIndex;
   }
 
-  return flatIndex;
+  // Not first line: previous line lengths + current column
+  return diff.deletedLineOffsets()[editLine] + bufferPos.col;
 }
 
 Position CompositionOptimizer::editIndexToBufferPos(int flatIndex, const DiffState& diff) const {
   // Convert flat index within insertedLines to buffer position
   // The new buffer has insertedLines at diff.newLineStart()
-  Lines inserted = diff.insertedLines();
-
-  int remaining = flatIndex;
-  for (int i = 0; i < static_cast<int>(inserted.size()); i++) {
-    int lineLen = static_cast<int>(inserted[i].size());
-    if (remaining < lineLen) {
-      // Found the line
-      // For first line of mid-line diff, add the starting column offset
-      int col = remaining;
-      if (i == 0) {
-        col += diff.posBegin.col;  // Offset within the line where edit starts
-      }
-      return Position(diff.newLineStart() + i, col);
+  const Lines& inserted = diff.insertedLines();
+  const vector<int>& offsets = diff.insertedLineOffsets();
+
+  // First line that ends after flatIndex (empty lines end where they start)
+  auto lineEnd = upper_bound(offsets.begin() + 1, offsets.end(), flatIndex);
+  if (lineEnd != offsets.end()) {
+    int i = static_cast<int>(lineEnd - offsets.begin()) - 1;
+    int col = flatIndex - offsets[i];
+    if (i == 0) {
+      col += diff.posBegin.col;  // Offset within the line where edit starts
     }
-    remaining -= lineLen;
+    return Position(diff.newLineStart() + i, col);
   }
 
   // If we get here, index was at end of last line
@@ -364,67 +731,54 @@ Position CompositionOptimizer::editIndexToBufferPos(int flatIndex, const DiffSta
   return Position(lastLine, lastCol);
 }
 
-vector<EditResult> CompositionOptimizer::calculateEditResults(const vector<DiffState>& diffStates) {
-  EditOptimizer editOptimizer(config);
-  vector<EditResult> results;
-  results.reserve(diffStates.size());
-
-  for (const DiffState& diff : diffStates) {
-    EditResult result = editOptimizer.optimizeEdit(
-        diff.deletedLines(),
-        diff.insertedLines(),
-        diff.boundary
-    );
-    results.push_back(std::move(result));
+SharedEditResult CompositionOptimizer::solveEditRegion(const DiffState& diff, const OptimizerParams& params) {
+  EditResultKey key(diff, hashConfig(config));
+  if (SharedEditResult cached = editCache->find(key)) {
+    return cached;
   }
 
-  return results;
-}
-
-vector<Lines> CompositionOptimizer::calculateLinesAfterDiffs(const Lines& startLines, const vector<DiffState>& diffStates, int totalEdits) {
-  assert(totalEdits == static_cast<int>(diffStates.size()));
-  vector<Lines> res(totalEdits + 1);
-  res[0] = startLines;
-  for (int i = 1; i <= totalEdits; i++) {
-    res[i] = Myers::applyDiffState(diffStates[i - 1], res[i - 1]);
+  EditOptimizer editOptimizer(config);
+  auto solved = make_shared<const EditResult>(editOptimizer.optimizeEdit(
+      diff.deletedLines(),
+      diff.insertedLines(),
+      diff.boundary,
+      params
+  ));
+
+  // A cancelled solve may be partial; don't keep it
+  if (!params.cancel.isCancelled()) {
+    editCache->insert(key, solved);
   }
-  return res;
+  return solved;
 }
 
-vector<vector<int>> CompositionOptimizer::buildPosToEditIndex(
-    const vector<DiffState>& diffStates,
-    int maxPosKey
-) {
-  vector<vector<int>> posToEditIndex(maxPosKey);
-
-  for (int editIdx = 0; editIdx < static_cast<int>(diffStates.size()); editIdx++) {
-    const DiffState& diff = diffStates[editIdx];
-
-    // For character-level diffs, mark only positions within the actual edit region
-    // posBegin and posEnd define the exact character boundaries
-
-    if (diff.isPureInsertion()) {
-      // Pure insertion: mark only the insertion point
-      int posKey = posToKey(diff.posBegin);
-      if (posKey >= 0 && posKey < maxPosKey) {
-        posToEditIndex[posKey].push_back(editIdx);
-      }
+VersionedLines CompositionOptimizer::calculateLinesAfterDiffs(const Lines& startLines, const vector<DiffState>& diffStates, int totalEdits) {
+  assert(totalEdits == static_cast<int>(diffStates.size()));
+  VersionedLines res(startLines);
+  for (int i = 0; i < totalEdits; i++) {
+    const DiffState& diff = diffStates[i];
+    const Lines& lines = res.tip();
+
+    // Only the lines the deleted text spans change; a deletion that runs past
+    // the end of a line takes the following lines with it
+    int first = diff.posBegin.line;
+    int last = first;
+    size_t end = diff.posBegin.col + diff.deletedText.size();
+    string text;
+    if (lines.empty()) {
+      first = 0;
+      last = -1;
     } else {
-      // Deletion or replacement: mark positions from posBegin to posEnd
-      // Handle single-line and multi-line cases
-      for (int line = diff.posBegin.line; line <= diff.posEnd.line; line++) {
-        int startCol = (line == diff.posBegin.line) ? diff.posBegin.col : 0;
-        int endCol = (line == diff.posEnd.line) ? diff.posEnd.col : maxLineLength - 1;
-
-        for (int col = startCol; col <= endCol; col++) {
-          int posKey = line * maxLineLength + col;
-          if (posKey >= 0 && posKey < maxPosKey) {
-            posToEditIndex[posKey].push_back(editIdx);
-          }
-        }
+      text = lines[first];
+      while (text.size() < end && last + 1 < static_cast<int>(lines.size())) {
+        text += '\n';
+        text += lines[++last];
       }
     }
-  }
 
-  return posToEditIndex;
+    size_t begin = min(static_cast<size_t>(diff.posBegin.col), text.size());
+    string changed = text.substr(0, begin) + diff.insertedText + text.substr(min(end, text.size()));
+    res.push(first, last - first + 1, Lines::unflatten(changed));
+  }
+  return res;
 }
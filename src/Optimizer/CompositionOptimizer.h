@@ -2,12 +2,15 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include <optional>
 
 #include "Config.h"
 #include "Result.h"
 #include "OptimizerParams.h"
 #include "EditOptimizer.h"
+#include "EditResultCache.h"
+#include "EditRegionIndex.h"
 #include "DiffState.h"
 #include "ImpliedExclusions.h"
 #include "Editor/NavContext.h"
@@ -15,6 +18,7 @@
 #include "State/CompositionState.h"
 #include "Keyboard/MotionToKeys.h"
 #include "Utils/Lines.h"
+#include "Utils/VersionedLines.h"
 
 struct CompositionOptimizer {
   Config config;
@@ -26,19 +30,22 @@ struct CompositionOptimizer {
   double overshootPenalty = 3.0;
   // Slight bias towards forward (natural left->right, top->bottom order)
   double forwardBias = 2.0;
-  // Max line length for position key encoding
-  int maxLineLength = 100;
+  // Reuse a movement sub-search for every state that repeats it within one
+  // optimize() call. Off only to check the memo against fresh sub-searches.
+  bool memoizeSubSearches = true;
+  // Solved edit regions, kept across optimize() calls. Optimizers can share one.
+  std::shared_ptr<EditResultCache> editCache = std::make_shared<EditResultCache>();
 
   CompositionOptimizer(const Config& config, OptimizerParams params = {},
-                       double overshootPenalty = 3.0, double forwardBias = 2.0,
-                       int maxLineLength = 100)
+                       double overshootPenalty = 3.0, double forwardBias = 2.0)
       : config(std::move(config)),
         defaultParams(params),
         overshootPenalty(overshootPenalty),
-        forwardBias(forwardBias),
-        maxLineLength(maxLineLength) {}
+        forwardBias(forwardBias) {}
 
-  // Composes edit transitions + movement. Pre-computes edit regions, then searches for optimal sequence.
+  // Composes edit transitions + movement. Edit regions are solved as the search reaches them,
+  // and with params.threads > 1 ahead of it on the shared TaskScheduler.
+  // With params.searchThreads > 1 the search is hash-distributed over that many threads.
   // Much slower; ~ O(n^2) + Sigma (m_i)^3, higher constant factor.
   std::vector<Result> optimize(
     const std::vector<std::string>& startLines,
@@ -65,10 +72,18 @@ struct CompositionOptimizer {
                    const std::vector<DiffState>& diffStates,
                    const OptimizerParams& params) const;
 
-  // Compute suffix sums of minimum edit costs
-  // suffixEditCosts[i] = sum of min costs for edits i..totalEdits-1
+  // Compute suffix sums of estimated edit costs
+  // suffixEditCosts[i] = sum of costs for edits i..totalEdits-1
   // suffixEditCosts[totalEdits] = 0
-  std::vector<double> computeSuffixEditCosts(const std::vector<EditResult>& editResults) const;
+  // Unsolved regions (null results) count with editCostLowerBound
+  std::vector<double> computeSuffixEditCosts(const std::vector<SharedEditResult>& editResults,
+                                             const std::vector<DiffState>& diffStates) const;
+
+  // Median cost over a solved region's valid entries
+  double editCostEstimate(const EditResult& editResult) const;
+
+  // Cheap bound for a region that hasn't been solved yet
+  double editCostLowerBound(const DiffState& diff) const;
 
   // Convert buffer position to flat index within edit region's deletedLines
   // Returns -1 if position is not in the edit region
@@ -77,24 +92,12 @@ struct CompositionOptimizer {
   // Convert flat index within edit region's insertedLines to buffer position
   Position editIndexToBufferPos(int flatIndex, const DiffState& diff) const;
 
-  // Solve each edit region independently
-  std::vector<EditResult> calculateEditResults(const std::vector<DiffState>& diffStates);
-
-  // Build intermediate buffer states after each diff
-  std::vector<Lines> calculateLinesAfterDiffs(const Lines& startLines, const std::vector<DiffState>& diffStates, int totalEdits);
-
-  // Build position -> editIndex map
-  // posToEditIndex[posKey] = list of edit indices that can be started from this position
-  // posKey = line * MAX_LINE_LENGTH + col
-  // Overlaps possible when edits shrink the buffer
-  // Lookup: check if editsCompleted is in posToEditIndex[posKey]
-  std::vector<std::vector<int>> buildPosToEditIndex(
-      const std::vector<DiffState>& diffStates,
-      int maxPosKey
-  );
+  // Solve one edit region, or take it from editCache. optimize() calls it once
+  // per distinct region (see EditResultKey), from the search or ahead of it on
+  // up to params.threads threads.
+  SharedEditResult solveEditRegion(const DiffState& diff, const OptimizerParams& params);
 
-  // Convert Position to posKey
-  int posToKey(const Position& pos) const {
-    return pos.line * maxLineLength + pos.col;
-  }
+  // Build intermediate buffer states after each diff. Version d is the buffer
+  // after the first d diffs; each version stores only the lines it changed.
+  VersionedLines calculateLinesAfterDiffs(const Lines& startLines, const std::vector<DiffState>& diffStates, int totalEdits);
 };
@@ -1,10 +1,40 @@
 #include "DiffState.h"
 
+#include "Utils/Mismatch.h"
+
 #include <algorithm>
 #include <cassert>
+#include <string_view>
+#include <unordered_map>
 
 using namespace std;
 
+// Characters before each line, plus the total; newlines are not counted
+static vector<int> charOffsets(const Lines& lines) {
+  vector<int> offsets;
+  offsets.reserve(lines.size() + 1);
+  int idx = 0;
+  for (const auto& line : lines) {
+    offsets.push_back(idx);
+    idx += static_cast<int>(line.size());
+  }
+  offsets.push_back(idx);
+  return offsets;
+}
+
+DiffState::DiffState(Position posBegin, Position posEnd,
+                     string deletedText, string insertedText,
+                     EditBoundary boundary)
+    : posBegin(posBegin),
+      posEnd(posEnd),
+      deletedText(std::move(deletedText)),
+      insertedText(std::move(insertedText)),
+      boundary(boundary),
+      deletedLines_(Lines::unflatten(this->deletedText)),
+      insertedLines_(Lines::unflatten(this->insertedText)),
+      deletedOffsets_(charOffsets(deletedLines_)),
+      insertedOffsets_(charOffsets(insertedLines_)) {}
+
 namespace Myers {
 
 // Minimum length for a common substring to be preserved as a separate match.
@@ -36,20 +66,26 @@ static bool isWordBoundaryChar(char c) {
 // Position Mapping Utilities
 // =============================================================================
 
-// Convert flat index in flattened text to (line, col) Position
-// Flattened text uses \n as line separator
-static Position flatIndexToPosition(int idx, const string& flatText) {
-  int line = 0;
-  int col = 0;
-  for (int i = 0; i < idx && i < static_cast<int>(flatText.size()); i++) {
-    if (flatText[i] == '\n') {
-      line++;
-      col = 0;
-    } else {
-      col++;
-    }
+// Flat index of the first character of each line, plus one past the end
+static vector<int> lineOffsets(const Lines& lines) {
+  vector<int> offsets;
+  offsets.reserve(lines.size() + 1);
+  int idx = 0;
+  for (const auto& line : lines) {
+    offsets.push_back(idx);
+    idx += static_cast<int>(line.size()) + 1;  // +1 for \n
   }
-  return Position(line, col);
+  offsets.push_back(idx);
+  return offsets;
+}
+
+// Convert flat index in flattened text to (line, col) Position
+// Flattened text uses \n as line separator; offsets come from lineOffsets()
+static Position flatIndexToPosition(int idx, const vector<int>& offsets) {
+  if (offsets.size() < 2) return Position(0, idx);
+  auto next = upper_bound(offsets.begin(), offsets.end() - 1, idx);
+  int line = static_cast<int>(next - offsets.begin()) - 1;
+  return Position(line, idx - offsets[line]);
 }
 
 // Convert (line, col) Position to flat index in flattened text
@@ -80,131 +116,361 @@ static int positionToFlatIndex(const Position& pos, const Lines& lines) {
 // - Moving down (+y) = INSERT from target
 // - Diagonal (+x, +y) = KEEP (match, free move)
 // - Goal: find shortest path from (0,0) to (n,m)
+//
+// The traceback needs V as it was before each round. Rather than copying V
+// every round (O(D * (N+M)) memory), the forward search keeps a few
+// checkpointed frontiers and the traceback divides and conquers over the
+// rounds: each span is re-run from its checkpoint, split again if it is still
+// long, and traced back from saved frontiers once it is short. A frontier
+// after round d only holds diagonals [-d-1, d+1], so memory stays O(N + M + D).
 
 // Internal: represents an edit operation
 enum class EditOp { KEEP, DELETE, INSERT };
 
-// Traceback from the saved history to reconstruct edit operations
-static vector<EditOp> myersTraceback(
-    const vector<vector<int>>& trace,
-    int d_final, int n, int m, int offset,
-    const string& a, const string& b) {
+class MyersSearch {
+  // Spans of at most this many rounds are traced back from saved frontiers
+  static constexpr int TRACE_ROUNDS = 32;
+  // Checkpoints kept per span when a longer span is split
+  static constexpr int SPLITS = 16;
 
-  vector<EditOp> ops;
-  int x = n, y = m;
-
-  // Work backwards from d_final to d=1
-  for (int d = d_final; d > 0; d--) {
-    int k = x - y;
-    const vector<int>& V_prev = trace[d];
-
-    // Determine which direction we came from
-    int prev_k;
-    bool was_insert;
-
-    if (k == -d || (k != d && V_prev[k - 1 + offset] < V_prev[k + 1 + offset])) {
-      // Came from k+1 (insert: moved down)
-      prev_k = k + 1;
-      was_insert = true;
-    } else {
-      // Came from k-1 (delete: moved right)
-      prev_k = k - 1;
-      was_insert = false;
-    }
+  struct Checkpoint {
+    int round;
+    vector<int> frontier;
+  };
 
-    // Position at end of previous round on prev_k diagonal
-    int end_x = V_prev[prev_k + offset];
-    int end_y = end_x - prev_k;
+  string_view a;
+  string_view b;
+  int n;
+  int m;
+  int offset;
+
+  // V[k + offset] = furthest x position reached on diagonal k (x - y = k)
+  vector<int> V;
+
+public:
+  MyersSearch(string_view a, string_view b)
+      : a(a), b(b), n(static_cast<int>(a.size())), m(static_cast<int>(b.size())),
+        offset(n + m + 1), V(2 * (n + m) + 3, 0) {}
+
+  // Choose: come from diagonal k-1 (delete) or k+1 (insert)
+  // - k == -d: must come from k+1 (can't go further left)
+  // - k == d: must come from k-1 (can't go further right)
+  // - Otherwise: choose the one that reaches further
+  // - Prefer delete (k-1) on tie for consistent output
+  // `prev(k)` reads the frontier after round d-1
+  template <typename Frontier>
+  static bool cameFromInsert(const Frontier& prev, int d, int k) {
+    return k == -d || (k != d && prev(k - 1) < prev(k + 1));
+  }
+
+  // Run round d in place over the frontier of round d-1.
+  // Returns true once (n, m) is reached.
+  bool step(int d) {
+    auto prev = [&](int k) { return V[k + offset]; };
+    for (int k = -d; k <= d; k += 2) {
+      int x = cameFromInsert(prev, d, k)
+          ? V[k + 1 + offset]       // insert: come from k+1, x stays same
+          : V[k - 1 + offset] + 1;  // delete: come from k-1, x increases
+      int y = x - k;
 
-    // Position right after the edit (before snake/diagonal extension)
-    int snake_start_x = was_insert ? end_x : end_x + 1;
-    int snake_start_y = was_insert ? end_y + 1 : end_y;
+      // Snake: greedily follow diagonal (matches) as far as possible
+      if (x < n && y < m) {
+        int run = static_cast<int>(mismatchLength(a.data() + x, b.data() + y, min(n - x, m - y)));
+        x += run; y += run;
+      }
 
-    // Add diagonal moves (snake) that happened after the edit
-    while (x > snake_start_x && y > snake_start_y) {
-      ops.push_back(EditOp::KEEP);
-      x--; y--;
-    }
+      V[k + offset] = x;
 
-    // Add the edit
-    if (was_insert) {
-      ops.push_back(EditOp::INSERT);
-      y--;
-    } else {
-      ops.push_back(EditOp::DELETE);
-      x--;
+      // Check if we've reached the goal
+      if (x >= n && y >= m) {
+        return true;
+      }
     }
+    return false;
   }
 
-  // d=0: initial diagonal moves from (0,0) before any edits
-  while (x > 0 && y > 0) {
-    ops.push_back(EditOp::KEEP);
-    x--; y--;
+  // Diagonals [-d-1, d+1] after round d: everything round d+1 reads
+  vector<int> save(int d) const {
+    return vector<int>(V.begin() + offset - d - 1, V.begin() + offset + d + 2);
   }
 
-  // Reverse to get forward order
-  reverse(ops.begin(), ops.end());
-  return ops;
-}
+  void restore(const vector<int>& frontier, int d) {
+    copy(frontier.begin(), frontier.end(), V.begin() + offset - d - 1);
+  }
 
-// Myers O(ND) diff algorithm - finds shortest edit script
-static vector<EditOp> tracePath(const string& a, const string& b) {
-  int n = static_cast<int>(a.size());
-  int m = static_cast<int>(b.size());
+  // Trace back from (x, y), where the path is at the end of round hi, to
+  // where it was at the end of round lo, appending ops in reverse order.
+  // `frontier` is the saved frontier after round lo.
+  void traceRounds(const vector<int>& frontier, int lo, int hi,
+                   int& x, int& y, vector<EditOp>& ops) {
+    restore(frontier, lo);
+
+    if (hi - lo > TRACE_ROUNDS) {
+      // Re-run the span once, checkpointing it, then trace the pieces
+      // back to front
+      int span = (hi - lo + SPLITS - 1) / SPLITS;
+      vector<Checkpoint> checkpoints;
+      for (int d = lo + 1; d < hi; d++) {
+        step(d);
+        if ((d - lo) % span == 0) {
+          checkpoints.push_back({d, save(d)});
+        }
+      }
+      int end = hi;
+      for (auto it = checkpoints.rbegin(); it != checkpoints.rend(); ++it) {
+        traceRounds(it->frontier, it->round, end, x, y, ops);
+        end = it->round;
+      }
+      traceRounds(frontier, lo, end, x, y, ops);
+      return;
+    }
 
-  // Handle edge cases
-  if (n == 0 && m == 0) return {};
-  if (n == 0) return vector<EditOp>(m, EditOp::INSERT);
-  if (m == 0) return vector<EditOp>(n, EditOp::DELETE);
+    // history[d - lo - 1] = frontier after round d-1, for d in (lo, hi]
+    vector<vector<int>> history;
+    history.reserve(hi - lo);
+    for (int d = lo + 1; d <= hi; d++) {
+      history.push_back(save(d - 1));
+      step(d);
+    }
 
-  int max_d = n + m;
-  int offset = max_d + 1;  // To handle negative diagonal indices
-  int V_size = 2 * max_d + 3;
+    for (int d = hi; d > lo; d--) {
+      const vector<int>& saved = history[d - lo - 1];
+      auto prev = [&](int k) { return saved[k + d]; };  // saved covers [-d, d]
+      int k = x - y;
 
-  // V[k + offset] = furthest x position reached on diagonal k
-  // Diagonal k means: x - y = k
-  vector<int> V(V_size, 0);
-  vector<vector<int>> trace;  // History for traceback
+      // Determine which direction we came from
+      bool was_insert = cameFromInsert(prev, d, k);
+      int prev_k = was_insert ? k + 1 : k - 1;
 
-  // Sentinel: V[1] = 0 allows the algorithm to start cleanly
-  V[1 + offset] = 0;
+      // Position at end of previous round on prev_k diagonal
+      int end_x = prev(prev_k);
+      int end_y = end_x - prev_k;
 
-  for (int d = 0; d <= max_d; d++) {
-    // Save V at the start of this round for traceback
-    trace.push_back(V);
+      // Position right after the edit (before snake/diagonal extension)
+      int snake_start_x = was_insert ? end_x : end_x + 1;
+      int snake_start_y = was_insert ? end_y + 1 : end_y;
 
-    for (int k = -d; k <= d; k += 2) {
-      int x;
-
-      // Choose: come from diagonal k-1 (delete) or k+1 (insert)
-      // - k == -d: must come from k+1 (can't go further left)
-      // - k == d: must come from k-1 (can't go further right)
-      // - Otherwise: choose the one that reaches further
-      // - Prefer delete (k-1) on tie for consistent output
-      if (k == -d || (k != d && V[k - 1 + offset] < V[k + 1 + offset])) {
-        x = V[k + 1 + offset];      // insert: come from k+1, x stays same
+      // Add diagonal moves (snake) that happened after the edit
+      while (x > snake_start_x && y > snake_start_y) {
+        ops.push_back(EditOp::KEEP);
+        x--; y--;
+      }
+
+      // Add the edit
+      if (was_insert) {
+        ops.push_back(EditOp::INSERT);
+        y--;
       } else {
-        x = V[k - 1 + offset] + 1;  // delete: come from k-1, x increases
+        ops.push_back(EditOp::DELETE);
+        x--;
       }
+    }
+  }
 
-      int y = x - k;
+  vector<EditOp> trace() {
+    // Forward pass to find D. Checkpoints are taken every `stride` rounds;
+    // when there are too many, every other one is dropped and the stride doubles.
+    vector<Checkpoint> checkpoints;
+    int stride = TRACE_ROUNDS;
+    int d_final = 0;
+    for (int d = 0; !step(d); d++) {
+      if (d % stride == 0) {
+        checkpoints.push_back({d, save(d)});
+      }
+      if (static_cast<int>(checkpoints.size()) > SPLITS) {
+        stride *= 2;
+        erase_if(checkpoints, [stride](const Checkpoint& c) { return c.round % stride != 0; });
+      }
+      d_final = d + 1;
+    }
 
-      // Snake: greedily follow diagonal (matches) as far as possible
-      while (x < n && y < m && a[x] == b[y]) {
-        x++; y++;
+    vector<EditOp> ops;
+    int x = n, y = m;
+    if (d_final > 0) {
+      int end = d_final;
+      for (auto it = checkpoints.rbegin(); it != checkpoints.rend(); ++it) {
+        traceRounds(it->frontier, it->round, end, x, y, ops);
+        end = it->round;
       }
+    }
 
-      V[k + offset] = x;
+    // d=0: initial diagonal moves from (0,0) before any edits
+    while (x > 0 && y > 0) {
+      ops.push_back(EditOp::KEEP);
+      x--; y--;
+    }
 
-      // Check if we've reached the goal
-      if (x >= n && y >= m) {
-        return myersTraceback(trace, d, n, m, offset, a, b);
+    // Reverse to get forward order
+    reverse(ops.begin(), ops.end());
+    return ops;
+  }
+};
+
+// Myers O(ND) diff algorithm - finds shortest edit script
+static vector<EditOp> tracePath(string_view a, string_view b) {
+  // The common prefix is exactly the d=0 snake, so trimming it up front
+  // leaves the script unchanged. A common suffix is not trimmed: the greedy
+  // search may match into it earlier, and which script wins ties matters.
+  size_t prefix = mismatchLength(a.data(), b.data(), min(a.size(), b.size()));
+  a.remove_prefix(prefix);
+  b.remove_prefix(prefix);
+
+  int n = static_cast<int>(a.size());
+  int m = static_cast<int>(b.size());
+
+  vector<EditOp> ops(prefix, EditOp::KEEP);
+  if (n == 0) {
+    ops.insert(ops.end(), m, EditOp::INSERT);
+  } else if (m == 0) {
+    ops.insert(ops.end(), n, EditOp::DELETE);
+  } else {
+    vector<EditOp> rest = MyersSearch(a, b).trace();
+    ops.insert(ops.end(), rest.begin(), rest.end());
+  }
+  return ops;
+}
+
+// =============================================================================
+// Line Anchoring
+// =============================================================================
+//
+// Before the character-level search, lines that are clearly unchanged are
+// pinned with a line-level patience diff: common prefix/suffix lines are
+// trimmed, then lines occurring exactly once on each side are matched along
+// their longest increasing subsequence, recursing between matches. Myers then
+// only runs on the text between anchored lines, so the cost scales with the
+// size of the changed hunks instead of the whole buffer.
+
+// Append matched (startLine, endLine) pairs for a[a0, a1) vs b[b0, b1), in order
+static void anchorLines(const Lines& a, int a0, int a1,
+                        const Lines& b, int b0, int b1,
+                        vector<pair<int, int>>& matches) {
+  // Common prefix
+  while (a0 < a1 && b0 < b1 && a[a0] == b[b0]) {
+    matches.emplace_back(a0++, b0++);
+  }
+  // Common suffix (appended after the middle)
+  int suffix = 0;
+  while (a0 < a1 - suffix && b0 < b1 - suffix && a[a1 - 1 - suffix] == b[b1 - 1 - suffix]) {
+    suffix++;
+  }
+  a1 -= suffix;
+  b1 -= suffix;
+
+  if (a0 < a1 && b0 < b1) {
+    // Lines unique on both sides: count, and remember where they are
+    struct Occurrence {
+      int countA = 0;
+      int countB = 0;
+      int lineA = 0;
+      int lineB = 0;
+    };
+    unordered_map<string_view, Occurrence> occurrences;
+    for (int i = a0; i < a1; i++) {
+      Occurrence& o = occurrences[a[i]];
+      o.countA++;
+      o.lineA = i;
+    }
+    for (int j = b0; j < b1; j++) {
+      auto it = occurrences.find(b[j]);
+      if (it != occurrences.end()) {
+        it->second.countB++;
+        it->second.lineB = j;
       }
     }
+
+    // Unique pairs in start order; keep the longest run increasing in end order
+    vector<pair<int, int>> unique;
+    for (int i = a0; i < a1; i++) {
+      const Occurrence& o = occurrences[a[i]];
+      if (o.countA == 1 && o.countB == 1) {
+        unique.emplace_back(i, o.lineB);
+      }
+    }
+
+    // Patience sorting: tails[l] = index in `unique` ending the best run of length l+1
+    vector<int> tails;
+    vector<int> previous(unique.size(), -1);
+    for (int u = 0; u < static_cast<int>(unique.size()); u++) {
+      auto pos = lower_bound(tails.begin(), tails.end(), unique[u].second,
+                             [&](int t, int lineB) { return unique[t].second < lineB; });
+      if (pos != tails.begin()) {
+        previous[u] = *(pos - 1);
+      }
+      if (pos == tails.end()) {
+        tails.push_back(u);
+      } else {
+        *pos = u;
+      }
+    }
+    vector<pair<int, int>> anchors;
+    for (int u = tails.empty() ? -1 : tails.back(); u != -1; u = previous[u]) {
+      anchors.push_back(unique[u]);
+    }
+    reverse(anchors.begin(), anchors.end());
+
+    // Recurse between anchors; ranges without any anchor are left to Myers
+    int lastA = a0;
+    int lastB = b0;
+    for (const auto& [i, j] : anchors) {
+      anchorLines(a, lastA, i, b, lastB, j, matches);
+      matches.emplace_back(i, j);
+      lastA = i + 1;
+      lastB = j + 1;
+    }
+    if (!anchors.empty()) {
+      anchorLines(a, lastA, a1, b, lastB, b1, matches);
+    }
   }
 
-  // Should never reach here for valid input
-  return {};
+  for (int s = 0; s < suffix; s++) {
+    matches.emplace_back(a1 + s, b1 + s);
+  }
+}
+
+// Edit script over the flattened buffers. Anchored lines are kept as-is and
+// Myers runs on the text between them (the gaps always hold the newlines).
+static vector<EditOp> anchoredPath(const Lines& startLines, const Lines& endLines,
+                                   const string& startText, const string& endText,
+                                   const vector<int>& startOffsets) {
+  vector<pair<int, int>> matches;
+  anchorLines(startLines, 0, static_cast<int>(startLines.size()),
+              endLines, 0, static_cast<int>(endLines.size()), matches);
+
+  vector<int> endOffsets = lineOffsets(endLines);
+
+  vector<EditOp> ops;
+  ops.reserve(max(startText.size(), endText.size()));
+  int origIdx = 0;
+  int newIdx = 0;
+
+  // Diff the gap up to (origEnd, newEnd), then keep `keep` characters
+  auto emit = [&](int origEnd, int newEnd, int keep) {
+    vector<EditOp> gap = tracePath(string_view(startText).substr(origIdx, origEnd - origIdx),
+                                   string_view(endText).substr(newIdx, newEnd - newIdx));
+    ops.insert(ops.end(), gap.begin(), gap.end());
+    ops.insert(ops.end(), keep, EditOp::KEEP);
+    origIdx = origEnd + keep;
+    newIdx = newEnd + keep;
+  };
+
+  // Consecutive matches form one kept run, including the newlines inside it
+  for (size_t r = 0; r < matches.size();) {
+    auto [i, j] = matches[r];
+    size_t e = r + 1;
+    while (e < matches.size() && matches[e].first == matches[e - 1].first + 1
+           && matches[e].second == matches[e - 1].second + 1) {
+      e++;
+    }
+    int lastLine = matches[e - 1].first;
+    int runLength = startOffsets[lastLine] + static_cast<int>(startLines[lastLine].size())
+                  - startOffsets[i];
+    emit(startOffsets[i], endOffsets[j], runLength);
+    r = e;
+  }
+  emit(static_cast<int>(startText.size()), static_cast<int>(endText.size()), 0);
+
+  return ops;
 }
 
 // =============================================================================
@@ -275,8 +541,9 @@ vector<DiffState> calculate(const Lines& startLines, const Lines& endLines) {
   string startText = startLines.flatten();
   string endText = endLines.flatten();
 
-  // Get character-level edit operations
-  vector<EditOp> ops = tracePath(startText, endText);
+  // Get character-level edit operations, anchored on unchanged lines
+  vector<int> startOffsets = lineOffsets(startLines);
+  vector<EditOp> ops = anchoredPath(startLines, endLines, startText, endText, startOffsets);
 
   vector<DiffState> result;
   int origIdx = 0;  // Current position in startText
@@ -418,24 +685,20 @@ vector<DiffState> calculate(const Lines& startLines, const Lines& endLines) {
 
     // Only create a diff if there's actually something to change
     if (!deleted.empty() || !inserted.empty()) {
-      DiffState diff;
-      diff.deletedText = deleted;
-      diff.insertedText = inserted;
-
       // Compute position bounds
-      diff.posBegin = flatIndexToPosition(startOrigIdx, startText);
+      Position posBegin = flatIndexToPosition(startOrigIdx, startOffsets);
 
       // posEnd is inclusive, so it's the position of the last deleted char
       // For pure insertions, posEnd == posBegin (insertion point)
-      if (deleted.empty()) {
-        diff.posEnd = diff.posBegin;
-      } else {
-        diff.posEnd = flatIndexToPosition(startOrigIdx + static_cast<int>(deleted.size()) - 1, startText);
+      Position posEnd = posBegin;
+      if (!deleted.empty()) {
+        posEnd = flatIndexToPosition(startOrigIdx + static_cast<int>(deleted.size()) - 1, startOffsets);
       }
 
       // Compute EditBoundary
-      diff.boundary = computeEditBoundary(startLines, diff.posBegin, diff.posEnd, deleted);
+      EditBoundary boundary = computeEditBoundary(startLines, posBegin, posEnd, deleted);
 
+      DiffState diff(posBegin, posEnd, std::move(deleted), std::move(inserted), boundary);
       result.push_back(std::move(diff));
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "EditBoundary.h"
@@ -18,6 +19,7 @@ struct DiffState {
   Position posEnd;    // Last character that differs (inclusive)
 
   // The actual content being deleted/inserted (flattened with \n for newlines)
+  // Fixed at construction: the line views below are derived from them.
   std::string deletedText;   // Characters being removed (may contain \n)
   std::string insertedText;  // Characters being added (may contain \n)
 
@@ -25,15 +27,25 @@ struct DiffState {
   // Computed once per DiffState, used for per-position safety checking
   EditBoundary boundary;
 
-  // Convert to Lines format for EditOptimizer compatibility
-  Lines deletedLines() const { return Lines::unflatten(deletedText); }
-  Lines insertedLines() const { return Lines::unflatten(insertedText); }
+  DiffState() : DiffState({}, {}, "", "") {}
+  DiffState(Position posBegin, Position posEnd,
+            std::string deletedText, std::string insertedText,
+            EditBoundary boundary = {});
+
+  // Lines format for EditOptimizer compatibility, split once at construction
+  const Lines& deletedLines() const { return deletedLines_; }
+  const Lines& insertedLines() const { return insertedLines_; }
+
+  // Characters (newlines excluded) before each line of deletedLines() /
+  // insertedLines(), plus the total at the end
+  const std::vector<int>& deletedLineOffsets() const { return deletedOffsets_; }
+  const std::vector<int>& insertedLineOffsets() const { return insertedOffsets_; }
 
   // Derived accessors
   int origLineStart() const { return posBegin.line; }
-  int origLineCount() const { return deletedLines().size(); }
+  int origLineCount() const { return static_cast<int>(deletedLines_.size()); }
   int newLineStart() const { return posBegin.line; }  // Same as origLineStart after adjustment
-  int newLineCount() const { return insertedLines().size(); }
+  int newLineCount() const { return static_cast<int>(insertedLines_.size()); }
 
   int origCharCount() const { return static_cast<int>(deletedText.size()); }
   int newCharCount() const { return static_cast<int>(insertedText.size()); }
@@ -42,6 +54,12 @@ struct DiffState {
   bool isPureInsertion() const { return deletedText.empty() && !insertedText.empty(); }
   bool isPureDeletion() const { return !deletedText.empty() && insertedText.empty(); }
   bool isReplacement() const { return !deletedText.empty() && !insertedText.empty(); }
+
+private:
+  Lines deletedLines_;
+  Lines insertedLines_;
+  std::vector<int> deletedOffsets_;
+  std::vector<int> insertedOffsets_;
 };
 
 // Character-level Myers diff algorithm.
@@ -15,33 +15,18 @@
 #include "State/EditState.h"
 #include "State/RunningEffort.h"
 #include "Utils/Debug.h"
+#include "Utils/ParallelFor.h"
 
+#include <limits>
 #include <queue>
 #include <unordered_map>
 #include <optional>
 #include <climits>
+#include <cstdint>
+#include <string_view>
 
 using namespace std;
 
-// =============================================================================
-// Heuristic for A* search
-// =============================================================================
-
-double EditOptimizer::heuristic(const EditState& s, const OptimizerParams& params) const {
-  // For deletion: total characters remaining + line count + mode penalty
-  double total = 0;
-  for (const auto& line : s.lines) {
-    total += line.size();
-  }
-  if (s.lines.size() > 1) {
-    total += s.lines.size() - 1;  // Newlines to delete
-  }
-  if (s.mode != Mode::Insert) {
-    total += 1;  // Need to enter insert mode
-  }
-  return total;
-}
-
 // =============================================================================
 // optimizeEdit - uses deletion search as foundation
 // =============================================================================
@@ -50,6 +35,7 @@ EditResult EditOptimizer::optimizeEdit(const Lines& sourceLines,
                                        const Lines& endLines,
                                        const EditBoundary& boundary,
                                        const optional<OptimizerParams>& paramsOverride) {
+  const OptimizerParams params = OptimizerParams::merge(defaultParams, paramsOverride);
   int n = sourceLines.size();
   int m = endLines.size();
 
@@ -75,7 +61,8 @@ EditResult EditOptimizer::optimizeEdit(const Lines& sourceLines,
   }
 
   // Run deletion search with boundary constraints
-  DeletionResult delResult = optimizeDeletion(sourceLines, boundary);
+  DeletionResult delResult = optimizeDeletion(sourceLines, boundary, params.cancel,
+                                                 static_cast<unsigned>(params.threads));
 
   // Copy results into EditResult structure
   for (int r = 0; r < n; r++) {
@@ -92,50 +79,135 @@ EditResult EditOptimizer::optimizeEdit(const Lines& sourceLines,
 // Deletion Search - A* to find optimal ways to clear buffer from any position
 // =============================================================================
 
-// Operations to explore in deletion search
-static const vector<string> DELETION_OPS = {
-  // Line operations
-  "dd", "cc", "S",
-  // Word deletions
-  "dw", "dW", "de", "dE", "db", "dB", "dge", "dgE",
-  // Word changes (enters insert mode)
-  "cw", "cW", "ce", "cE", "cb", "cB", "cge", "cgE",
-  // Line-partial operations
-  "D", "d$", "C", "c$", "d0", "c0", "d^", "c^",
-  // Character operations
-  "x", "s",
-  // Text objects
-  "diw", "daw", "diW", "daW",
-  "ciw", "caw", "ciW", "caW",
-  // Navigation (no buffer change, but needed to reach different positions)
-  "j", "k", "h", "l",
-  "w", "W", "b", "B", "e", "E", "ge", "gE",
-  "0", "^", "$",
+// How the boundary check treats an op
+enum class EditOpKind : uint8_t {
+  FULL_LINE,        // dd, cc, S
+  FORWARD,          // x, dw, de, D, ... (see ForwardEdit)
+  BACKWARD,         // db, dge, d0, ... (see BackwardEdit)
+  SUBSTITUTE,       // s: x, then insert
+  INNER_WORD,       // diw, ciw
+  INNER_BIG_WORD,   // diW, ciW
+  AROUND_WORD,      // daw, caw
+  AROUND_BIG_WORD,  // daW, caW
+  VERTICAL_NAV,     // j, k
+  NAV,              // other cursor motions
 };
 
+// An operation of the deletion search, with everything the search needs
+// resolved up front so expanding a state does no string work.
+struct EditOpDescriptor {
+  ParsedEdit edit{""};                         // op text, hashed once
+  EditOpKind kind;
+  ForwardEdit forward = ForwardEdit::CHAR;     // when kind == FORWARD
+  BackwardEdit backward = BackwardEdit::CHAR;  // when kind == BACKWARD
+  bool isDd = false;                           // dd has extra cursor-escape rules
+  PhysicalKeys keys;
+};
+
+// Physical keys for an operation, from ALL_MOTIONS or a character-based fallback
+static PhysicalKeys opKeys(string_view op) {
+  auto it = ALL_MOTIONS.find(string(op));
+  if (it != ALL_MOTIONS.end()) {
+    return it->second;
+  }
+  PhysicalKeys keys;
+  for (char c : op) {
+    auto cit = CHAR_TO_KEYS.find(c);
+    if (cit != CHAR_TO_KEYS.end()) {
+      keys.append(cit->second);
+    }
+  }
+  return keys;
+}
+
+// Operations to explore in deletion search, built once
+static const vector<EditOpDescriptor>& deletionOps() {
+  static const vector<EditOpDescriptor> ops = [] {
+    using K = EditOpKind;
+    using F = ForwardEdit;
+    using B = BackwardEdit;
+    vector<EditOpDescriptor> v;
+    auto add = [&v](string_view text, K kind) -> EditOpDescriptor& {
+      EditOpDescriptor& op = v.emplace_back();
+      op.edit = ParsedEdit(text);
+      op.kind = kind;
+      op.keys = opKeys(text);
+      return op;
+    };
+    auto fwd = [&](string_view text, F edit) { add(text, K::FORWARD).forward = edit; };
+    auto bwd = [&](string_view text, B edit) { add(text, K::BACKWARD).backward = edit; };
+
+    // Line operations
+    add("dd", K::FULL_LINE).isDd = true;
+    add("cc", K::FULL_LINE);
+    add("S", K::FULL_LINE);
+    // Word deletions
+    fwd("dw", F::WORD_TO_START);
+    fwd("dW", F::BIG_WORD_TO_START);
+    fwd("de", F::WORD_TO_END);
+    fwd("dE", F::BIG_WORD_TO_END);
+    bwd("db", B::WORD_TO_START);
+    bwd("dB", B::BIG_WORD_TO_START);
+    bwd("dge", B::WORD_TO_END);
+    bwd("dgE", B::BIG_WORD_TO_END);
+    // Word changes (enters insert mode)
+    fwd("cw", F::WORD_TO_START);
+    fwd("cW", F::BIG_WORD_TO_START);
+    fwd("ce", F::WORD_TO_END);
+    fwd("cE", F::BIG_WORD_TO_END);
+    bwd("cb", B::WORD_TO_START);
+    bwd("cB", B::BIG_WORD_TO_START);
+    bwd("cge", B::WORD_TO_END);
+    bwd("cgE", B::BIG_WORD_TO_END);
+    // Line-partial operations
+    for (string_view op : {"D", "d$", "C", "c$"}) fwd(op, F::LINE_TO_END);
+    for (string_view op : {"d0", "c0", "d^", "c^"}) bwd(op, B::LINE_TO_START);
+    // Character operations
+    fwd("x", F::CHAR);
+    add("s", K::SUBSTITUTE);
+    // Text objects
+    add("diw", K::INNER_WORD);
+    add("daw", K::AROUND_WORD);
+    add("diW", K::INNER_BIG_WORD);
+    add("daW", K::AROUND_BIG_WORD);
+    add("ciw", K::INNER_WORD);
+    add("caw", K::AROUND_WORD);
+    add("ciW", K::INNER_BIG_WORD);
+    add("caW", K::AROUND_BIG_WORD);
+    // Navigation (no buffer change, but needed to reach different positions)
+    for (string_view op : {"j", "k"}) add(op, K::VERTICAL_NAV);
+    for (string_view op : {"h", "l", "w", "W", "b", "B", "e", "E", "ge", "gE", "0", "^", "$"}) {
+      add(op, K::NAV);
+    }
+    return v;
+  }();
+  return ops;
+}
+
 // Check if state is a goal state for deletion search
 // If boundary has lines above/below, we can only clear to single empty line (can't delete all lines)
-static bool isDeletionGoal(const EditState& s, const EditBoundary& boundary) {
+static bool isDeletionGoal(const EditState& state, const EditBoundary& boundary) {
+  const Lines& lines = *state.lines;
   // Must be in insert mode
-  if (s.mode != Mode::Insert) return false;
+  if (state.mode != Mode::Insert) return false;
 
   // If there are lines outside the region, we can only reduce to single empty line
   bool canDeleteAllLines = !boundary.hasLinesAbove && !boundary.hasLinesBelow;
 
   if (canDeleteAllLines) {
     // Can reach truly empty buffer
-    if (s.lines.empty()) return true;
+    if (lines.empty()) return true;
   }
 
   // Single empty line is always a valid goal
-  if (s.lines.size() == 1 && s.lines[0].empty()) return true;
+  if (lines.size() == 1 && lines[0].empty()) return true;
 
   // For partial-line regions, we can't reduce line count (no dd/J allowed),
   // so goal is "all lines empty" - preserves line structure
   bool isPartialLineRegion = !boundary.startsAtLineStart || !boundary.endsAtLineEnd;
-  if (isPartialLineRegion && s.lines.size() > 1) {
+  if (isPartialLineRegion && lines.size() > 1) {
     bool allEmpty = true;
-    for (const auto& line : s.lines) {
+    for (const auto& line : lines) {
       if (!line.empty()) {
         allEmpty = false;
         break;
@@ -147,84 +219,53 @@ static bool isDeletionGoal(const EditState& s, const EditBoundary& boundary) {
   return false;
 }
 
-// Heuristic: total characters remaining in buffer
-static double deletionHeuristic(const EditState& s) {
-  double total = 0;
-  for (const auto& line : s.lines) {
-    total += line.size();
-  }
-  // Add cost for lines (need to delete newlines too)
-  if (s.lines.size() > 1) {
-    total += s.lines.size() - 1;
-  }
-  // Not in insert mode yet - add small cost
-  if (s.mode != Mode::Insert) {
-    total += 1;
-  }
-  return total;
-}
-
-// Map operation string to ForwardEdit enum
-static optional<ForwardEdit> getForwardEditType(const string& op) {
-  if (op == "x") return ForwardEdit::CHAR;
-  if (op == "dw" || op == "cw") return ForwardEdit::WORD_TO_START;
-  if (op == "de" || op == "ce") return ForwardEdit::WORD_TO_END;
-  if (op == "dW" || op == "cW") return ForwardEdit::BIG_WORD_TO_START;
-  if (op == "dE" || op == "cE") return ForwardEdit::BIG_WORD_TO_END;
-  if (op == "D" || op == "C" || op == "d$" || op == "c$") return ForwardEdit::LINE_TO_END;
-  return nullopt;
-}
-
-// Map operation string to BackwardEdit enum
-static optional<BackwardEdit> getBackwardEditType(const string& op) {
-  if (op == "X") return BackwardEdit::CHAR;
-  if (op == "db" || op == "cb") return BackwardEdit::WORD_TO_START;
-  if (op == "dge" || op == "cge") return BackwardEdit::WORD_TO_END;
-  if (op == "dB" || op == "cB") return BackwardEdit::BIG_WORD_TO_START;
-  if (op == "dgE" || op == "cgE") return BackwardEdit::BIG_WORD_TO_END;
-  if (op == "d0" || op == "c0" || op == "d^" || op == "c^") return BackwardEdit::LINE_TO_START;
-  return nullopt;
+// Heuristic: lower bound on the effort still needed. Every goal is in Insert
+// mode, and a non-goal state needs at least one more key.
+// Characters remaining would guide the search faster, but it overestimates
+// (dd clears a whole line for two keys). Since all starts share one frontier,
+// an overestimate lets the region around the first start starve the others.
+static double deletionHeuristic(bool isGoal) {
+  return isGoal ? 0.0 : 1.0;
 }
 
 // Check if operation is valid given boundary constraints
-static bool isOpValidForBoundary(const EditState& s, const string& op, const EditBoundary& boundary) {
+static bool isOpValidForBoundary(const EditState& s, const EditOpDescriptor& op, const EditBoundary& boundary) {
   // Get current line content and cursor position
-  if (s.lines.empty()) return true;  // Empty buffer, any op is fine
-  const string& currentLine = s.lines[s.pos.line];
+  const Lines& lines = *s.lines;
+  if (lines.empty()) return true;  // Empty buffer, any op is fine
+  const string& currentLine = lines[s.pos.line];
   int cursorCol = s.pos.col;
 
   // Partial-line region detection
   bool isPartialLineRegion = !boundary.startsAtLineStart || !boundary.endsAtLineEnd;
-  bool isMultiLine = s.lines.size() > 1;
+  bool isMultiLine = lines.size() > 1;
 
-  if (isPartialLineRegion && isMultiLine) {
-    // Block explicit line join operations - these would merge lines in full buffer
-    if (op == "J" || op == "gJ") return false;
+  switch (op.kind) {
+  // Block j/k navigation in partial-line regions - column offsets differ between lines.
+  // When k goes from line 1 col 0 to line 0 col 0, in full buffer that's a different
+  // relative position within each line's edit region (or outside it entirely).
+  case EditOpKind::VERTICAL_NAV:
+    return !(isPartialLineRegion && isMultiLine);
 
-    // Block j/k navigation - column offsets differ between lines in partial-line regions.
-    // When k goes from line 1 col 0 to line 0 col 0, in full buffer that's a different
-    // relative position within each line's edit region (or outside it entirely).
-    if (op == "j" || op == "k") return false;
-  }
+  // Other navigation - generally safe
+  case EditOpKind::NAV:
+    return true;
 
   // Full-line operations (dd, cc, S)
-  static const vector<string> FULL_LINE_OPS = {"dd", "cc", "S"};
-  bool isFullLineOp = find(FULL_LINE_OPS.begin(), FULL_LINE_OPS.end(), op) != FULL_LINE_OPS.end();
-
-  if (isFullLineOp) {
+  case EditOpKind::FULL_LINE: {
     // Use existing isFullLineEditSafe
     if (!isFullLineEditSafe(boundary)) {
       return false;  // Would delete content outside edit region
     }
 
     // dd-specific constraints for cursor escape
-    if (op == "dd") {
-      bool isLastLine = (s.pos.line == (int)s.lines.size() - 1);
+    if (op.isDd) {
+      bool isLastLine = (s.pos.line == (int)lines.size() - 1);
       if (isLastLine && boundary.hasLinesBelow) {
         return false;  // Cursor would escape to content below
       }
       // Can't dd if it would leave us with 0 lines but there are lines above/below
-      if (s.lines.size() == 1 && (boundary.hasLinesAbove || boundary.hasLinesBelow)) {
+      if (lines.size() == 1 && (boundary.hasLinesAbove || boundary.hasLinesBelow)) {
         return false;  // Can't delete the only line if there's surrounding content
       }
     }
@@ -232,13 +273,13 @@ static bool isOpValidForBoundary(const EditState& s, const string& op, const Edi
   }
 
   // Forward edit operations - check with isForwardEditSafe
-  auto fwdType = getForwardEditType(op);
-  if (fwdType) {
-    bool isLastLine = (s.pos.line == (int)s.lines.size() - 1);
+  case EditOpKind::FORWARD: {
+    ForwardEdit fwdType = op.forward;
+    bool isLastLine = (s.pos.line == (int)lines.size() - 1);
     int lineLen = currentLine.size();
     bool atOrNearLineEnd = (lineLen == 0) || (cursorCol >= lineLen - 1);
 
-    if (*fwdType != ForwardEdit::CHAR && *fwdType != ForwardEdit::LINE_TO_END) {
+    if (fwdType != ForwardEdit::CHAR && fwdType != ForwardEdit::LINE_TO_END) {
       // For partial-line multi-line regions, forward word ops from ANY position
       // on non-last lines can reach next line (w/e/E cross lines easily)
       // This would join lines and corrupt the full buffer.
@@ -259,7 +300,7 @@ static bool isOpValidForBoundary(const EditState& s, const string& op, const Edi
     // WORD_TO_START (dw, cw, dW, cW) includes trailing whitespace after the word.
     // On last line with endsAtLineEnd=false, this whitespace is OUTSIDE the edit region.
     // Block these operations entirely on last line for partial-line regions.
-    if (*fwdType == ForwardEdit::WORD_TO_START || *fwdType == ForwardEdit::BIG_WORD_TO_START) {
+    if (fwdType == ForwardEdit::WORD_TO_START || fwdType == ForwardEdit::BIG_WORD_TO_START) {
       if (isLastLine && !boundary.endsAtLineEnd) {
         return false;
       }
@@ -268,19 +309,19 @@ static bool isOpValidForBoundary(const EditState& s, const string& op, const Edi
     // CHAR (x) at last column of last line with endsAtLineEnd=false:
     // After deletion, cursor lands on content OUTSIDE the edit region.
     // Subsequent operations would affect outside content.
-    if (*fwdType == ForwardEdit::CHAR) {
+    if (fwdType == ForwardEdit::CHAR) {
       if (isLastLine && !boundary.endsAtLineEnd && atOrNearLineEnd) {
         return false;
       }
     }
 
-    return isForwardEditSafe(currentLine, cursorCol, boundary, *fwdType);
+    return isForwardEditSafe(currentLine, cursorCol, boundary, fwdType);
   }
 
   // Backward edit operations - check with isBackwardEditSafe
-  auto bwdType = getBackwardEditType(op);
-  if (bwdType) {
-    if (*bwdType != BackwardEdit::CHAR && *bwdType != BackwardEdit::LINE_TO_START) {
+  case EditOpKind::BACKWARD: {
+    BackwardEdit bwdType = op.backward;
+    if (bwdType != BackwardEdit::CHAR && bwdType != BackwardEdit::LINE_TO_START) {
       // For partial-line multi-line regions, backward word ops from ANY position
       // on non-first lines can reach previous line (ge/b cross lines easily)
       // This would join lines and corrupt the full buffer.
@@ -298,7 +339,7 @@ static bool isOpValidForBoundary(const EditState& s, const string& op, const Edi
         return false;
       }
     }
-    return isBackwardEditSafe(currentLine, cursorCol, boundary, *bwdType);
+    return isBackwardEditSafe(currentLine, cursorCol, boundary, bwdType);
   }
 
   // Text object operations - need careful boundary checking
@@ -313,74 +354,163 @@ static bool isOpValidForBoundary(const EditState& s, const string& op, const Edi
   // because they'll grab whitespace that's outside the edit region.
 
   // Inner word text objects - safe when boundary is at word edge (not in middle)
-  if (op == "diw" || op == "ciw") {
+  case EditOpKind::INNER_WORD:
     return !boundary.left_in_word && !boundary.right_in_word;
-  }
-  if (op == "diW" || op == "ciW") {
+  case EditOpKind::INNER_BIG_WORD:
     return !boundary.left_in_WORD && !boundary.right_in_WORD;
-  }
 
   // Around word text objects - only safe when boundary cuts through word
   // (meaning there's no adjacent whitespace to grab outside the region)
   // For partial-line regions, "around" is almost never safe
-  if (op == "daw" || op == "caw") {
+  case EditOpKind::AROUND_WORD:
     // Safe only if BOTH boundaries cut through words (no exposed whitespace)
     // AND we're at full line boundaries (no adjacent content)
-    if (!boundary.startsAtLineStart || !boundary.endsAtLineEnd) {
+    if (isPartialLineRegion) {
       return false;  // Partial line - around would grab adjacent whitespace
     }
     return boundary.left_in_word && boundary.right_in_word;
-  }
-  if (op == "daW" || op == "caW") {
-    if (!boundary.startsAtLineStart || !boundary.endsAtLineEnd) {
+  case EditOpKind::AROUND_BIG_WORD:
+    if (isPartialLineRegion) {
       return false;  // Partial line - around would grab adjacent whitespace
     }
     return boundary.left_in_WORD && boundary.right_in_WORD;
-  }
 
   // 's' (substitute char) is like 'x' then insert
-  if (op == "s") {
+  case EditOpKind::SUBSTITUTE:
     return isForwardEditSafe(currentLine, cursorCol, boundary, ForwardEdit::CHAR);
   }
-
-  // Navigation and other operations - generally safe
   return true;
 }
 
-// Try to apply an operation to a state, return new state if valid
-static optional<EditState> tryApplyOp(const EditState& s, const string& op,
-                                       const Config& config, const NavContext& ctx,
-                                       const EditBoundary& boundary) {
+// Try to apply an operation to a state, return new state if valid.
+// Only buffer, position and mode are updated; effort is accounted by the caller.
+// Navigation shares the buffer; edits copy it.
+static optional<EditState> tryApplyOp(const EditState& s, const EditOpDescriptor& op,
+                                       const NavContext& ctx, const EditBoundary& boundary) {
   // Check boundary constraints before attempting
   if (!isOpValidForBoundary(s, op, boundary)) {
     return nullopt;
   }
 
-  EditState newState = s;
-  try {
-    Edit::applyEdit(newState.lines, newState.pos, newState.mode, ctx, ParsedEdit(op));
-    // Compute cost using ALL_MOTIONS or character-based fallback
-    auto it = ALL_MOTIONS.find(op);
-    if (it != ALL_MOTIONS.end()) {
-      newState.effort.append(it->second, config);
-    } else {
-      // Try character-based cost for unknown ops
-      for (char c : op) {
-        auto cit = CHAR_TO_KEYS.find(c);
-        if (cit != CHAR_TO_KEYS.end()) {
-          newState.effort.append(cit->second, config);
-        }
-      }
-    }
-    newState.seq.push_back(op);
+  // Rejects most invalid ops before the buffer is copied
+  const ParsedEdit& edit = op.edit;
+  if (Edit::checkEdit(*s.lines, s.pos, s.mode, edit) != EditStatus::Ok) {
+    return nullopt;
+  }
+
+  EditState newState;
+  newState.lines = s.lines;
+  newState.fingerprint = s.fingerprint;
+  newState.pos = s.pos;
+  newState.mode = s.mode;
+  if (op.kind == EditOpKind::NAV || op.kind == EditOpKind::VERTICAL_NAV) {
+    Edit::applyNavigation(*s.lines, newState.pos, newState.mode, edit);
     return newState;
-  } catch (...) {
-    // Operation invalid in this state
+  }
+  Lines edited = *s.lines;
+  if (Edit::applyCheckedEdit(edited, newState.pos, newState.mode, ctx, edit) != EditStatus::Ok) {
     return nullopt;
   }
+  newState.fingerprint = make_shared<const BufferFingerprint>(
+      s.fingerprint->updated(*s.lines, edited));
+  newState.lines = make_shared<const Lines>(std::move(edited));
+  return newState;
 }
 
-DeletionResult EditOptimizer::optimizeDeletion(const Lines& source, const EditBoundary& boundary) {
+// =============================================================================
+// Deletion Search
+// =============================================================================
+//
+// All start positions share one state graph, so it is explored once:
+//
+// 1. Forward: multi-source A* from every start, each (buffer, pos, mode) state
+//    expanded at most once. g is the distance from the nearest start. The
+//    edges found (state --op--> state) are recorded.
+// 2. Reverse: Dijkstra from all goal states over the recorded edges in reverse,
+//    giving every state its cost-to-goal and best next op. Each start's
+//    sequence is read off by following those ops.
+//
+// Edge weights are each op's standalone effort. The real effort is
+// context-dependent (same-finger, rolls, ...), so each reported sequence is
+// re-scored with a RunningEffort; the choice between sequences ignores
+// cross-op bigrams.
+//
+// The forward pass stops once every start has a path and the cheapest open
+// f-value exceeds the worst start's cost-to-goal, since nothing left in the
+// queue can improve any start. Checking requires a reverse pass, so it is done
+// at geometrically spaced expansion counts.
+
+namespace {
+
+struct DeletionEdge {
+  int op;  // index into deletionOps()
+  int to;
+};
+
+struct DeletionGraph {
+  vector<EditState> states;
+  vector<vector<DeletionEdge>> edges;
+  vector<bool> isGoal;
+  unordered_map<EditStateKey, int, EditStateKeyHash> index;
+
+  // Returns {id, inserted}
+  pair<int, bool> intern(EditState&& s, bool goal) {
+    auto [it, inserted] = index.try_emplace(s.getKey(), static_cast<int>(states.size()));
+    if (inserted) {
+      states.push_back(std::move(s));
+      edges.emplace_back();
+      isGoal.push_back(goal);
+    }
+    return {it->second, inserted};
+  }
+};
+
+struct CostToGoal {
+  vector<double> dist;
+  vector<DeletionEdge> next;  // best first step; op == -1 at goals/unreached
+};
+
+CostToGoal reverseDijkstra(const DeletionGraph& graph, const vector<double>& opCost) {
+  int n = graph.states.size();
+  vector<vector<DeletionEdge>> reverse(n);  // to = predecessor
+  for (int from = 0; from < n; from++) {
+    for (const DeletionEdge& e : graph.edges[from]) {
+      reverse[e.to].push_back({e.op, from});
+    }
+  }
+
+  CostToGoal result{vector<double>(n, numeric_limits<double>::infinity()),
+                    vector<DeletionEdge>(n, DeletionEdge{-1, -1})};
+  using Item = pair<double, int>;
+  priority_queue<Item, vector<Item>, greater<Item>> pq;
+  for (int i = 0; i < n; i++) {
+    if (graph.isGoal[i]) {
+      result.dist[i] = 0;
+      pq.push({0, i});
+    }
+  }
+
+  while (!pq.empty()) {
+    auto [d, v] = pq.top();
+    pq.pop();
+    if (d > result.dist[v]) continue;
+    for (const DeletionEdge& e : reverse[v]) {
+      int u = e.to;
+      double nd = d + opCost[e.op];
+      if (nd < result.dist[u]) {
+        result.dist[u] = nd;
+        result.next[u] = {e.op, v};
+        pq.push({nd, u});
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+DeletionResult EditOptimizer::optimizeDeletion(const Lines& source, const EditBoundary& boundary,
+                                               const CancellationToken& cancel, unsigned threads) {
   int rows = source.size();
   int maxCols = 0;
   for (const auto& line : source) {
@@ -399,77 +529,123 @@ DeletionResult EditOptimizer::optimizeDeletion(const Lines& source, const EditBo
   // NavContext for edit operations
   NavContext ctx(100, 50);  // windowHeight, scrollAmount
 
-  // Priority queue: min-heap by cost
-  priority_queue<EditState, vector<EditState>, greater<EditState>> pq;
+  const vector<EditOpDescriptor>& ops = deletionOps();
+  vector<double> opCost;
+  for (const EditOpDescriptor& op : ops) {
+    RunningEffort standalone;
+    standalone.append(op.keys, config);
+    opCost.push_back(standalone.getEffort(config));
+  }
 
-  // Visited states: track best cost for each (startIndex, buffer, pos, mode) tuple
-  // Use map of startIndex -> (stateKey -> cost)
-  unordered_map<int, unordered_map<EditStateKey, double, EditStateKeyHash>> visited;
+  DeletionGraph graph;
+  vector<double> g;      // distance from nearest start, by state id
+  vector<bool> expanded;
+
+  // Forward frontier ordered by f = g + h
+  using Item = pair<double, int>;
+  priority_queue<Item, vector<Item>, greater<Item>> pq;
+
+  auto reach = [&](EditState&& s, double newG) {
+    bool goal = isDeletionGoal(s, boundary);
+    double h = deletionHeuristic(goal);
+    auto [id, inserted] = graph.intern(std::move(s), goal);
+    if (inserted) {
+      g.push_back(newG);
+      expanded.push_back(false);
+    } else if (newG >= g[id]) {
+      return id;
+    } else {
+      g[id] = newG;
+    }
+    if (!expanded[id] && !graph.isGoal[id]) {
+      pq.push({newG + h, id});
+    }
+    return id;
+  };
 
-  // Initialize with all starting positions
+  // Initialize with all starting positions, all sharing the source buffer
+  SharedLines sourceLines = make_shared<const Lines>(source);
+  SharedFingerprint sourceFingerprint = make_shared<const BufferFingerprint>(source);
+  vector<int> startIds(rows * maxCols, -1);
   for (int r = 0; r < rows; r++) {
     int cols = source[r].empty() ? 1 : source[r].size();
     for (int c = 0; c < cols; c++) {
       EditState initial;
-      initial.lines = source;
+      initial.lines = sourceLines;
+      initial.fingerprint = sourceFingerprint;
       initial.pos = Position(r, c);
       initial.mode = Mode::Normal;
-      initial.startIndex = r * maxCols + c;
-      initial.cost = deletionHeuristic(initial);
-      pq.push(initial);
+      startIds[r * maxCols + c] = reach(std::move(initial), 0.0);
     }
   }
 
   debug("DeletionSearch: starting with", pq.size(), "positions");
 
+  // Worst cost-to-goal over all starts, or infinity if some start has no path yet
+  auto worstStartCost = [&]() {
+    CostToGoal toGoal = reverseDijkstra(graph, opCost);
+    double worst = 0;
+    for (int id : startIds) {
+      if (id >= 0) worst = max(worst, toGoal.dist[id]);
+    }
+    return worst;
+  };
+
   int expansions = 0;
   const int maxExpansions = 100000;
+  int nextCheck = 0;  // armed once the first goal is found
 
   while (!pq.empty() && expansions < maxExpansions) {
-    EditState current = pq.top();
-    pq.pop();
-
-    // Check if already visited with better cost (per startIndex)
-    auto key = current.getKey();
-    auto& perStartVisited = visited[current.startIndex];
-    auto it = perStartVisited.find(key);
-    if (it != perStartVisited.end() && it->second <= current.getEffort(config)) {
-      continue;
+    if (cancel.isCancelled()) {
+      debug("DeletionSearch: cancelled");
+      break;
     }
-    perStartVisited[key] = current.getEffort(config);
-    expansions++;
 
-    // Check if goal
-    if (isDeletionGoal(current, boundary)) {
-      int idx = current.startIndex;
-      if (!result.results[idx].isValid() ||
-          current.getEffort(config) < result.results[idx].keyCost) {
-        result.results[idx] = Result(current.getSequenceString(), current.getEffort(config));
-        debug("Found goal for start", idx, ":", current.getSequenceString(),
-              "cost", current.getEffort(config));
+    auto [f, id] = pq.top();
+    if (nextCheck > 0 && expansions >= nextCheck) {
+      if (f > worstStartCost()) {
+        break;
       }
-      continue;  // Don't expand further from goal
+      nextCheck *= 2;
     }
+    pq.pop();
+    if (expanded[id]) continue;
+    expanded[id] = true;
+    expansions++;
 
     // Expand: try all operations
-    for (const auto& op : DELETION_OPS) {
-      auto newState = tryApplyOp(current, op, config, ctx, boundary);
-      if (newState) {
-        newState->startIndex = current.startIndex;
-        newState->cost = newState->getEffort(config) + deletionHeuristic(*newState);
-
-        // Only add if not visited with better cost (per startIndex)
-        auto newKey = newState->getKey();
-        auto& perStartVis = visited[newState->startIndex];
-        auto vit = perStartVis.find(newKey);
-        if (vit == perStartVis.end() || vit->second > newState->getEffort(config)) {
-          pq.push(*newState);
-        }
+    for (size_t op = 0; op < ops.size(); op++) {
+      auto newState = tryApplyOp(graph.states[id], ops[op], ctx, boundary);
+      if (!newState) continue;
+      int to = reach(std::move(*newState), g[id] + opCost[op]);
+      if (to == id) continue;  // no-op in this state
+      graph.edges[id].push_back({static_cast<int>(op), to});
+      if (nextCheck == 0 && graph.isGoal[to]) {
+        nextCheck = max(expansions, 64);
       }
     }
   }
 
-  debug("DeletionSearch: completed after", expansions, "expansions");
+  debug("DeletionSearch: explored", graph.states.size(), "states after", expansions, "expansions");
+
+  CostToGoal toGoal = reverseDijkstra(graph, opCost);
+  // Each start's sequence is read off and re-scored independently
+  parallelFor(startIds.size(), threads, [&](size_t idx) {
+    int id = startIds[idx];
+    if (id < 0 || toGoal.dist[id] == numeric_limits<double>::infinity()) return;
+
+    string seq;
+    PhysicalKeys keys;
+    RunningEffort effort;
+    for (int v = id; !graph.isGoal[v]; v = toGoal.next[v].to) {
+      int op = toGoal.next[v].op;
+      seq += ops[op].edit.edit;
+      keys.append(ops[op].keys);
+      effort.append(ops[op].keys, config);
+    }
+    result.results[idx] = Result(seq, keys, effort, config);
+    debug("Found goal for start", idx, ":", seq, "cost", result.results[idx].keyCost);
+  });
 
   return result;
 }
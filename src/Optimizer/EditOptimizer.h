@@ -54,16 +54,19 @@ struct EditOptimizer {
         defaultParams(params),
         absoluteExploreFactor(absoluteExploreFactor) {}
 
-  // Heuristic for A* search: effort + chars remaining
-  double heuristic(const EditState& s, const OptimizerParams& params) const;
-
-  // A* search to find optimal sequences to delete all content from each starting position.
+  // Finds optimal sequences to delete all content from each starting position.
+  // All starts share one explored state graph, solved backward from the goals,
+  // so cost grows with the number of states rather than states x starts.
   // Returns best sequence for each (row, col) starting position.
   // Goal state: buffer empty (or single empty line) AND in Insert mode.
   // Boundary constraints:
   // - If hasLinesBelow: can't dd on last line (cursor would escape to content below)
   // - If hasLinesAbove or hasLinesBelow: goal is single empty line (can't delete all lines)
-  DeletionResult optimizeDeletion(const Lines& source, const EditBoundary& boundary = EditBoundary{});
+  // A cancelled search stops early; positions not yet solved stay invalid.
+  // Reading off the per-start sequences runs on up to `threads` threads.
+  DeletionResult optimizeDeletion(const Lines& source, const EditBoundary& boundary = EditBoundary{},
+                                  const CancellationToken& cancel = CancellationToken(),
+                                  unsigned threads = 1);
 
   // DEPRECATED: Stub for CompositionOptimizer compatibility.
   // Returns empty result - CompositionOptimizer needs to be updated to use DeletionResult.
@@ -0,0 +1,49 @@
+#include "EditRegionIndex.h"
+
+#include <algorithm>
+
+using namespace std;
+
+EditRegionIndex::EditRegionIndex(const vector<DiffState>& diffStates) {
+  byEditIndex.reserve(diffStates.size());
+  for (int editIdx = 0; editIdx < static_cast<int>(diffStates.size()); editIdx++) {
+    const DiffState& diff = diffStates[editIdx];
+    // Pure insertion: only the insertion point
+    Position end = diff.isPureInsertion() ? diff.posBegin : diff.posEnd;
+    byEditIndex.push_back({diff.posBegin, end, editIdx});
+  }
+
+  regions = byEditIndex;
+  stable_sort(regions.begin(), regions.end(),
+              [](const Region& a, const Region& b) { return a.begin < b.begin; });
+
+  maxEnd.reserve(regions.size());
+  for (const Region& region : regions) {
+    maxEnd.push_back(maxEnd.empty() ? region.end : max(maxEnd.back(), region.end));
+  }
+}
+
+vector<int> EditRegionIndex::regionsAt(const Position& pos) const {
+  vector<int> result;
+
+  // Regions starting after pos can't contain it; walk back from the last one
+  // that starts at or before pos while some earlier region still ends past it
+  auto after = upper_bound(regions.begin(), regions.end(), pos,
+                           [](const Position& p, const Region& r) { return p < r.begin; });
+  for (int i = static_cast<int>(after - regions.begin()) - 1; i >= 0 && pos <= maxEnd[i]; i--) {
+    if (pos <= regions[i].end) {
+      result.push_back(regions[i].editIndex);
+    }
+  }
+
+  sort(result.begin(), result.end());
+  return result;
+}
+
+bool EditRegionIndex::contains(const Position& pos, int editIndex) const {
+  if (editIndex < 0 || editIndex >= static_cast<int>(byEditIndex.size())) {
+    return false;
+  }
+  const Region& region = byEditIndex[editIndex];
+  return region.begin <= pos && pos <= region.end;
+}
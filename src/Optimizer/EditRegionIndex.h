@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include "DiffState.h"
+#include "Editor/Position.h"
+
+// Which edit regions an edit can be started from at a given cursor position.
+// A region covers posBegin..posEnd in buffer order (every column of the lines
+// in between); a pure insertion covers only its insertion point. Regions are
+// kept sorted by start, with a running maximum of their ends, so a lookup is a
+// binary search plus a walk over the regions that can still reach it.
+class EditRegionIndex {
+  struct Region {
+    Position begin;
+    Position end;
+    int editIndex;
+  };
+
+  std::vector<Region> regions;      // Sorted by begin
+  std::vector<Position> maxEnd;     // maxEnd[i] = latest end among regions[0..i]
+  std::vector<Region> byEditIndex;  // Same regions, in edit order
+
+public:
+  EditRegionIndex() = default;
+  explicit EditRegionIndex(const std::vector<DiffState>& diffStates);
+
+  // Edit indices of all regions containing pos, in ascending order
+  std::vector<int> regionsAt(const Position& pos) const;
+
+  // Whether region editIndex contains pos
+  bool contains(const Position& pos, int editIndex) const;
+
+  size_t size() const { return regions.size(); }
+};
@@ -0,0 +1,76 @@
+#include "EditResultCache.h"
+
+#include "ResultCache.h"
+
+using namespace std;
+
+EditResultKey::EditResultKey(const DiffState& diff, uint64_t configHash)
+    : deletedText(diff.deletedText),
+      insertedText(diff.insertedText),
+      configHash(configHash) {
+  const EditBoundary& b = diff.boundary;
+  int bit = 0;
+  for (bool flag : {b.right_in_word, b.right_in_WORD, b.left_in_word, b.left_in_WORD,
+                    b.startsAtLineStart, b.endsAtLineEnd, b.hasLinesAbove, b.hasLinesBelow}) {
+    boundaryFlags |= static_cast<uint16_t>(flag) << bit++;
+  }
+}
+
+size_t EditResultKeyHash::operator()(const EditResultKey& k) const {
+  size_t h = k.configHash;
+  for (size_t v : {hash<string>{}(k.deletedText), hash<string>{}(k.insertedText),
+                   static_cast<size_t>(k.boundaryFlags)}) {
+    h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+  }
+  return h;
+}
+
+SharedEditResult EditResultCache::find(const EditResultKey& key) {
+  lock_guard lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    misses_++;
+    return nullptr;
+  }
+  hits_++;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->value;
+}
+
+void EditResultCache::insert(const EditResultKey& key, SharedEditResult value) {
+  lock_guard lock(mutex_);
+  if (auto it = index_.find(key); it != index_.end()) {
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  if (maxEntries_ == 0) {
+    return;
+  }
+  while (lru_.size() >= maxEntries_) {
+    index_.erase(lru_.back().key);
+    lru_.pop_back();
+  }
+  lru_.push_front(Entry{key, std::move(value)});
+  index_.emplace(lru_.front().key, lru_.begin());
+}
+
+void EditResultCache::clear() {
+  lock_guard lock(mutex_);
+  lru_.clear();
+  index_.clear();
+}
+
+size_t EditResultCache::size() const {
+  lock_guard lock(mutex_);
+  return lru_.size();
+}
+
+uint64_t EditResultCache::hits() const {
+  lock_guard lock(mutex_);
+  return hits_;
+}
+
+uint64_t EditResultCache::misses() const {
+  lock_guard lock(mutex_);
+  return misses_;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "DiffState.h"
+#include "EditOptimizer.h"
+
+using SharedEditResult = std::shared_ptr<const EditResult>;
+
+// What an edit region's solution depends on: its text before and after, the
+// boundary flags the search respects, and the keyboard config.
+// Position in the buffer is deliberately absent, so every occurrence of the
+// same rename shares one entry.
+struct EditResultKey {
+  std::string deletedText;
+  std::string insertedText;
+  uint16_t boundaryFlags = 0;
+  uint64_t configHash = 0;
+
+  EditResultKey(const DiffState& diff, uint64_t configHash);
+
+  bool operator==(const EditResultKey& other) const = default;
+};
+
+struct EditResultKeyHash {
+  size_t operator()(const EditResultKey& k) const;
+};
+
+// Thread-safe LRU of solved edit regions, bounded by entry count.
+class EditResultCache {
+  struct Entry {
+    EditResultKey key;
+    SharedEditResult value;
+  };
+
+  mutable std::mutex mutex_;
+  std::list<Entry> lru_; // front = most recently used
+  std::unordered_map<EditResultKey, std::list<Entry>::iterator, EditResultKeyHash> index_;
+  size_t maxEntries_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+
+public:
+  static constexpr size_t DEFAULT_MAX_ENTRIES = 512;
+
+  explicit EditResultCache(size_t maxEntries = DEFAULT_MAX_ENTRIES) : maxEntries_(maxEntries) {}
+
+  // Counts a hit or a miss; nullptr on a miss
+  SharedEditResult find(const EditResultKey& key);
+  void insert(const EditResultKey& key, SharedEditResult value);
+  void clear();
+
+  size_t size() const;
+  uint64_t hits() const;
+  uint64_t misses() const;
+};
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cmath>
 #include <functional>
+#include <limits>
 
 std::string join(const std::vector<std::string>& lines) {
   if (lines.empty()) return "";
@@ -25,7 +26,7 @@ std::string join(const std::vector<std::string>& lines) {
 
 
 Levenshtein::Levenshtein(std::string goal, double deletionCost)
-  : goal_(std::move(goal)), deletionCost_(deletionCost)
+  : goal_(std::move(goal)), prefixCache_(goal_.size() + 1), deletionCost_(deletionCost)
 {
   // Initialize base row: distance from empty string to goal[0..j]
   // This is always j insertions (cost 1 each), regardless of deletionCost
@@ -33,6 +34,15 @@ Levenshtein::Levenshtein(std::string goal, double deletionCost)
   for (size_t j = 0; j <= goal_.size(); ++j) {
     baseRow_[j] = static_cast<double>(j);
   }
+
+  if (deletionCost_ == 1.0) {
+    blocks_ = (goal_.size() + 63) / 64;
+    peq_.assign(256 * blocks_, 0);
+    for (size_t i = 0; i < goal_.size(); ++i) {
+      unsigned char c = static_cast<unsigned char>(goal_[i]);
+      peq_[c * blocks_ + i / 64] |= uint64_t{1} << (i % 64);
+    }
+  }
 }
 
 int Levenshtein::distance(const std::vector<std::string>& lines) const {
@@ -49,27 +59,78 @@ double Levenshtein::distanceDouble(const std::string& source) const {
   // Deleting all of source costs deletionCost_ per char
   if (goal_.empty()) return deletionCost_ * static_cast<double>(source.size());
 
-  // Find longest cached prefix
-  size_t cachedPrefixLen = 0;
-  const std::vector<double>* startRow = &baseRow_;
-
-  // Try progressively shorter prefixes until we find a cache hit
-  // For efficiency, we could use a trie, but hash lookup is simple and fast
-  for (size_t len = source.size(); len > 0; --len) {
-    size_t h = hashPrefix(source, len);
-    auto it = prefixCache_.find(h);
-    if (it != prefixCache_.end()) {
-      cachedPrefixLen = len;
-      startRow = &it->second;
-      break;
+  if (!peq_.empty()) {
+    return static_cast<double>(distanceBitParallel(source));
+  }
+  return distanceDP(source);
+}
+
+// Myers (1999) bit-vector edit distance, in Hyyro's blocked formulation.
+// Goal characters run down the column, one bit each; Pv/Mv hold the +1/-1
+// vertical deltas of the current column. Each source character advances the
+// column. Every block passes its horizontal delta at the bottom row (+1, 0 or
+// -1) to the block below; carries only move toward higher bits, so padding
+// bits above the goal's last character never affect the result.
+int Levenshtein::distanceBitParallel(const std::string& source) const {
+  const size_t m = goal_.size();
+  const uint64_t lastBit = uint64_t{1} << ((m - 1) % 64);
+  constexpr uint64_t HIGH_BIT = uint64_t{1} << 63;
+
+  auto step = [](uint64_t& pv, uint64_t& mv, uint64_t eq, int hin, uint64_t outBit) {
+    uint64_t xv = eq | mv;
+    if (hin < 0) eq |= 1;
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    int hout = (ph & outBit) ? 1 : (mh & outBit) ? -1 : 0;
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0) mh |= 1;
+    else if (hin > 0) ph |= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+  };
+
+  int score = static_cast<int>(m);
+
+  if (blocks_ == 1) {
+    uint64_t pv = ~uint64_t{0};
+    uint64_t mv = 0;
+    for (char ch : source) {
+      uint64_t eq = peq_[static_cast<unsigned char>(ch)];
+      // Top boundary row is 0, 1, 2, ...: always +1 into the first row
+      score += step(pv, mv, eq, 1, lastBit);
+    }
+    return score;
+  }
+
+  std::vector<uint64_t> pv(blocks_, ~uint64_t{0});
+  std::vector<uint64_t> mv(blocks_, 0);
+  for (char ch : source) {
+    const uint64_t* eq = &peq_[static_cast<unsigned char>(ch) * blocks_];
+    int carry = 1;
+    for (size_t b = 0; b + 1 < blocks_; ++b) {
+      carry = step(pv[b], mv[b], eq[b], carry, HIGH_BIT);
     }
+    score += step(pv[blocks_ - 1], mv[blocks_ - 1], eq[blocks_ - 1], carry, lastBit);
   }
+  return score;
+}
+
+double Levenshtein::distanceDP(const std::string& source) const {
+  // Find longest cached prefix: one walk down the trie
+  PrefixRowCache::Hit hit = prefixCache_.deepest(source);
+  size_t cachedPrefixLen = hit.length;
+  PrefixRowCache::Node node = hit.node;
 
   // Compute remaining rows
-  std::vector<double> prevRow = *startRow;
+  std::vector<double> prevRow = hit.row ? std::vector<double>(hit.row, hit.row + goal_.size() + 1)
+                                        : baseRow_;
   std::vector<double> currRow(goal_.size() + 1);
 
   for (size_t i = cachedPrefixLen; i < source.size(); ++i) {
+    node = prefixCache_.extend(node, source[i]);
     // Cost to transform source[0..i] to empty goal: (i+1) deletions
     currRow[0] = deletionCost_ * static_cast<double>(i + 1);
 
@@ -84,8 +145,7 @@ double Levenshtein::distanceDouble(const std::string& source) const {
     // Cache this row for future queries with this prefix
     // Only cache every few rows to balance memory vs. speed
     if ((i + 1) % cacheInterval_ == 0 || i == source.size() - 1) {
-      size_t h = hashPrefix(source, i + 1);
-      prefixCache_[h] = currRow;
+      prefixCache_.store(node, currRow.data());
     }
 
     std::swap(prevRow, currRow);
@@ -94,16 +154,87 @@ double Levenshtein::distanceDouble(const std::string& source) const {
   return prevRow[goal_.size()];
 }
 
-void Levenshtein::clearCache() {
-  prefixCache_.clear();
+std::optional<double> Levenshtein::distanceBanded(const std::string& source, size_t k,
+                                                  double maxCost) const {
+  constexpr double INF = std::numeric_limits<double>::infinity();
+  const size_t n = source.size();
+  const size_t m = goal_.size();
+
+  // Full-width rows, but only band cells [lo, hi] are ever written; the cells
+  // just outside the band are reset to INF so reads from them stay correct
+  std::vector<double> prevRow(m + 2, INF);
+  std::vector<double> currRow(m + 2, INF);
+  size_t prevHi = std::min(m, k);
+  for (size_t j = 0; j <= prevHi; ++j) {
+    prevRow[j] = static_cast<double>(j);
+  }
+
+  for (size_t i = 1; i <= n; ++i) {
+    size_t lo = i > k ? i - k : 0;
+    size_t hi = std::min(m, i + k);
+    if (lo > 0) currRow[lo - 1] = INF;
+    currRow[hi + 1] = INF;
+
+    double rowMin = INF;
+    for (size_t j = lo; j <= hi; ++j) {
+      double best;
+      if (j == 0) {
+        best = deletionCost_ * static_cast<double>(i);
+      } else {
+        double deleteCost = j <= prevHi ? prevRow[j] + deletionCost_ : INF;
+        double insertCost = j > lo ? currRow[j - 1] + 1.0 : INF;
+        double replaceCost = prevRow[j - 1] + (source[i - 1] == goal_[j - 1] ? 0.0 : 1.0);
+        best = std::min({deleteCost, insertCost, replaceCost});
+      }
+      currRow[j] = best;
+      rowMin = std::min(rowMin, best);
+    }
+    if (rowMin > maxCost) {
+      return std::nullopt;
+    }
+    std::swap(prevRow, currRow);
+    prevHi = hi;
+  }
+  return prevRow[m];
 }
 
-size_t Levenshtein::hashPrefix(const std::string& s, size_t len) {
-  // Use standard hash with length to avoid collisions between
-  // different strings with same prefix
-  size_t h = std::hash<std::string_view>{}(std::string_view(s.data(), len));
-  // Mix in length to distinguish "abc" prefix of "abcd" from "abc" prefix of "abcx"
-  h ^= len + 0x9e3779b9 + (h << 6) + (h >> 2);
-  return h;
+std::optional<double> Levenshtein::distanceBounded(const std::string& source,
+                                                   double maxCost) const {
+  const size_t n = source.size();
+  const size_t m = goal_.size();
+  size_t lengthGap = n > m ? n - m : m - n;
+
+  // A path touching diagonal offset d needs |d| insertions (d > 0) or
+  // deletions (d < 0), so leaving a band of width k costs > k * minStep
+  double minStep = std::min(1.0, deletionCost_);
+  double gapCost = n > m ? deletionCost_ * static_cast<double>(lengthGap)
+                         : static_cast<double>(lengthGap);
+  if (gapCost > maxCost) {
+    return std::nullopt;
+  }
+  if (minStep <= 0.0) {
+    // Free deletions: no band is safe, use the full DP
+    double d = distanceDouble(source);
+    return d <= maxCost ? std::optional<double>(d) : std::nullopt;
+  }
+
+  // Beyond this width, every path leaving the band already costs > maxCost
+  size_t maxWidth = std::min(std::max(n, m),
+                             static_cast<size_t>(std::floor(maxCost / minStep)));
+  size_t k = std::min(maxWidth, std::max<size_t>(lengthGap, 1));
+  while (true) {
+    std::optional<double> d = distanceBanded(source, k, maxCost);
+    if (k >= maxWidth) {
+      return d && *d <= maxCost ? d : std::nullopt;
+    }
+    // Exact once no path outside the band could be cheaper
+    if (d && *d <= static_cast<double>(k + 1) * minStep) {
+      return *d <= maxCost ? d : std::nullopt;
+    }
+    k = std::min(maxWidth, k * 2);
+  }
 }
 
+void Levenshtein::clearCache() {
+  prefixCache_.clear();
+}
@@ -1,17 +1,25 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
-#include <unordered_map>
+
+#include "PrefixRowCache.h"
 
 // -----------------------------------------------------------------------------
-// Levenshtein Distance with Prefix Caching
+// Levenshtein Distance
 // -----------------------------------------------------------------------------
 //
-// Future improvements (if needed):
-// - Ukkonen's algorithm: O(nd) where d = edit distance
-//   Faster when d is small, which is common in A* (we prioritize close states)
-// - Myers' bit-vector: O(nm/64) for m <= 64, uses SIMD-like bit parallelism
+// With unit costs (deletionCost == 1), uses Myers' bit-vector algorithm:
+// O(n * ceil(m/64)) for source length n and goal length m, one machine word
+// per column for goals up to 64 chars.
+// With fractional deletion costs, falls back to the O(nm) DP over doubles,
+// with cached DP rows for shared source prefixes (see PrefixRowCache).
+//
+// distanceBounded answers "distance, or more than maxCost?" with Ukkonen's
+// band: only cells within k of the diagonal are evaluated, O(nk), with k
+// doubled until the answer is exact or the band covers maxCost.
 //
 // -----------------------------------------------------------------------------
 
@@ -25,7 +33,7 @@ public:
   explicit Levenshtein(std::string goal, double deletionCost = 1.0);
 
   // Compute Levenshtein distance from source to goal.
-  // Uses cached DP rows for shared prefixes when available.
+  // The DP fallback uses cached rows for shared prefixes when available.
   int distance(const std::string& source) const;
   int distance(const std::vector<std::string>& lines) const;
 
@@ -39,18 +47,36 @@ public:
   // Lower = more memory, faster lookups. Higher = less memory, more recomputation.
   void setCacheInterval(size_t interval) { cacheInterval_ = interval; }
 
+  // Memory budget for cached rows; least recently used rows are evicted past it
+  void setCacheMaxBytes(size_t maxBytes) { prefixCache_.setMaxBytes(maxBytes); }
+  size_t cacheBytes() const { return prefixCache_.bytes(); }
+  size_t cachedRows() const { return prefixCache_.rows(); }
+
   // Compute distance as a double (for fractional deletion costs)
   double distanceDouble(const std::string& source) const;
 
+  // Distance from source to goal if it is at most maxCost, nullopt otherwise.
+  // Stops as soon as every cell of a row exceeds maxCost. Does not use the
+  // prefix cache.
+  std::optional<double> distanceBounded(const std::string& source, double maxCost) const;
+
 private:
   std::string goal_;
   std::vector<double> baseRow_;  // DP row for empty source string (using double for fractional costs)
-  mutable std::unordered_map<size_t, std::vector<double>> prefixCache_;
+  mutable PrefixRowCache prefixCache_;
   size_t cacheInterval_ = 4;
   double deletionCost_ = 1.0;  // Cost of deleting a source character
 
-  // Hash a prefix of the string for cache lookup
-  static size_t hashPrefix(const std::string& s, size_t len);
+  // Bit-vector kernel state, built once from the goal when deletionCost_ == 1.
+  // peq_[c * blocks_ + b] has bit i set when goal_[64 * b + i] == c.
+  std::vector<uint64_t> peq_;
+  size_t blocks_ = 0;
+
+  int distanceBitParallel(const std::string& source) const;
+
+  // DP restricted to |i - j| <= k. nullopt if some row is entirely over maxCost.
+  std::optional<double> distanceBanded(const std::string& source, size_t k, double maxCost) const;
+  double distanceDP(const std::string& source) const;
 };
 
 // -----------------------------------------------------------------------------
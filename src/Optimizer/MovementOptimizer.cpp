@@ -120,6 +120,11 @@ vector<Result> MovementOptimizer::optimize(
     pq.pop();
     Position pos = s.getPos();
 
+    if (params.cancel.isCancelled()) {
+      debug("search cancelled");
+      break;
+    }
+
     if (++totalExplored > params.maxSearchDepth) {
       debug("maximum total explored count reached");
       break;
@@ -232,6 +237,8 @@ vector<Result> MovementOptimizer::optimize(
     auto [l, c] = state;
     debug(l, c, cost);
   }
+
+  lastStats = SearchStats{totalExplored, userEffort, params.cancel.isCancelled()};
   return res;
 }
 
@@ -250,17 +257,17 @@ vector<RangeResult> MovementOptimizer::optimizeToRange(
   // Merge defaults with overrides
   const OptimizerParams params = OptimizerParams::merge(defaultParams, paramsOverride);
 
-  // Apply exclusions
-  MotionToKeys motionToKeys = rawMotionToKeys;
-  if (impliedExclusions.exclude_G) {
-    motionToKeys.erase("G");
-  }
-  if (impliedExclusions.exclude_gg) {
-    motionToKeys.erase("gg");
-  }
+  // Exclusions are skipped while expanding, rather than copying the motion map per call
+  auto isExcluded = [&](const string& motion) {
+    return (impliedExclusions.exclude_G && motion == "G")
+        || (impliedExclusions.exclude_gg && motion == "gg");
+  };
 
   int totalExplored = 0;
   double userEffort = getEffort(userSequence, config);
+  // States carry the caller's effort forward; the explore cutoff only counts the
+  // keys added here, so the results don't depend on how much came before
+  double priorEffort = startingEffort.getEffort(config);
 
   // Create initial state: effort=0 (fresh start), cost=heuristic
   // Only RunningEffort is continued from caller for correct typing effort calculation
@@ -287,7 +294,7 @@ vector<RangeResult> MovementOptimizer::optimizeToRange(
   // This ensures we find all optimal sequences (e.g., both 'w' and 'W' when they
   // have equal cost to reach the range).
   auto exploreNewState = [&](MotionState&& newState) {
-    if (newState.getEffort() > userEffort * params.exploreFactor) {
+    if (newState.getEffort() - priorEffort > userEffort * params.exploreFactor) {
       return;
     }
     double newCost = newState.getCost();
@@ -324,6 +331,11 @@ vector<RangeResult> MovementOptimizer::optimizeToRange(
     pq.pop();
     Position pos = s.getPos();
 
+    if (params.cancel.isCancelled()) {
+      debug("optimizeToRange: search cancelled");
+      break;
+    }
+
     if (++totalExplored > params.maxSearchDepth) {
       debug("optimizeToRange: max search depth reached");
       break;
@@ -337,7 +349,7 @@ vector<RangeResult> MovementOptimizer::optimizeToRange(
 
       if (allowMultiplePerPosition) {
         // Store all results, no filtering
-        allResults.emplace_back(s.getMotionSequence(), effort, pos);
+        allResults.emplace_back(s.getMotionSequence(), s.getPhysicalKeys(), effort, pos);
         if (allResults.size() >= static_cast<size_t>(params.maxResults)) {
           debug("optimizeToRange: max results reached");
           break;
@@ -347,7 +359,7 @@ vector<RangeResult> MovementOptimizer::optimizeToRange(
         auto it = bestResultByPos.find(stateKey);
         if (it == bestResultByPos.end()) {
           // New end position
-          bestResultByPos.emplace(stateKey, RangeResult(s.getMotionSequence(), effort, pos));
+          bestResultByPos.emplace(stateKey, RangeResult(s.getMotionSequence(), s.getPhysicalKeys(), effort, pos));
           uniquePositionsFound++;
           if (uniquePositionsFound >= params.maxResults) {
             debug("optimizeToRange: max unique positions reached");
@@ -355,7 +367,7 @@ vector<RangeResult> MovementOptimizer::optimizeToRange(
           }
         } else if (effort < it->second.keyCost) {
           // Strictly better path - replace
-          it->second = RangeResult(s.getMotionSequence(), effort, pos);
+          it->second = RangeResult(s.getMotionSequence(), s.getPhysicalKeys(), effort, pos);
         }
         // else: same or worse cost, ignore
       }
@@ -370,8 +382,10 @@ vector<RangeResult> MovementOptimizer::optimizeToRange(
     debug("\"" + s.getMotionSequence() + "\"", s.getCost());
 
     // Basic motions only (f-motion and count searches disabled for now)
-    for (const auto& [motion, keys] : motionToKeys) {
-      exploreMotion(s, motion, keys);
+    for (const auto& [motion, keys] : rawMotionToKeys) {
+      if (!isExcluded(motion)) {
+        exploreMotion(s, motion, keys);
+      }
     }
   }
 
@@ -20,6 +20,8 @@ using SearchParams = OptimizerParams;
 struct MovementOptimizer {
   Config config;
   OptimizerParams defaultParams;
+  // Filled in by optimize()
+  SearchStats lastStats;
 
   MovementOptimizer(const Config& config, OptimizerParams params = {})
       : config(config), defaultParams(params) {}
@@ -69,7 +71,8 @@ struct MovementOptimizer {
   );
 
   // Multi-sink movement optimization: find paths to any position in [rangeBegin, rangeEnd]
-  // Only RunningEffort maybe continued from previous state.
+  // Only RunningEffort maybe continued from previous state. Paths are pruned on the
+  // effort they add, so equal typing contexts give the same paths.
   // Returns up to params.maxResults unique end positions.
   // - allowMultiplePerPosition=false (default): at most 1 result per end position (best cost)
   // - allowMultiplePerPosition=true: allows multiple results per position (all found paths)
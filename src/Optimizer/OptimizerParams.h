@@ -2,6 +2,8 @@
 
 #include <optional>
 
+#include "Utils/CancellationToken.h"
+
 // Shared search parameters across all optimizers.
 // Can be set as defaults in constructor and optionally overridden per-call.
 struct OptimizerParams {
@@ -10,6 +12,17 @@ struct OptimizerParams {
   double costWeight = 1.0;
   double exploreFactor = 2.0;
   int fMotionThreshold = 2;
+  // Threads for phases made of independent subproblems (edit regions, the
+  // per-start sequences of one region). They run on the shared TaskScheduler,
+  // so this caps a call's share of its workers rather than starting threads.
+  // Results do not depend on it; 1 runs everything on the calling thread.
+  int threads = 1;
+  // Threads for the composition search itself (hash-distributed A*). The
+  // result set matches the single-threaded search up to ties and effort
+  // tolerance, not exactly; 1 keeps the sequential search.
+  int searchThreads = 1;
+  // Checked once per expansion; a cancelled search returns what it has so far.
+  CancellationToken cancel;
 
   OptimizerParams() = default;
 
@@ -33,3 +46,10 @@ struct OptimizerParams {
     return override.value_or(defaults);
   }
 };
+
+// Summary of the most recent search, for reporting back to callers.
+struct SearchStats {
+  int explored = 0;
+  double userEffort = 0.0;
+  bool cancelled = false;
+};
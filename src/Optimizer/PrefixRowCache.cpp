@@ -0,0 +1,127 @@
+#include "PrefixRowCache.h"
+
+#include <algorithm>
+
+using namespace std;
+
+PrefixRowCache::PrefixRowCache(size_t rowSize, size_t maxBytes)
+    : rowSize_(rowSize), maxBytes_(maxBytes) {
+  clear();
+}
+
+size_t PrefixRowCache::bytes() const {
+  // Node + hash map entry per live node, plus every row in use
+  constexpr size_t NODE_BYTES = sizeof(TrieNode) + sizeof(uint64_t) + sizeof(Node) + 2 * sizeof(void*);
+  return liveNodes() * NODE_BYTES + lru_.size() * rowSize_ * sizeof(double);
+}
+
+PrefixRowCache::Hit PrefixRowCache::deepest(const string& s) {
+  Node node = ROOT;
+  Node best = -1;
+  size_t bestLen = 0;
+  for (size_t i = 0; i < s.size(); i++) {
+    auto it = edges_.find(edgeKey(node, static_cast<unsigned char>(s[i])));
+    if (it == edges_.end()) break;
+    node = it->second;
+    if (nodes_[node].slot >= 0) {
+      best = node;
+      bestLen = i + 1;
+    }
+  }
+  if (best < 0) {
+    return Hit{};
+  }
+  lru_.splice(lru_.begin(), lru_, nodes_[best].lruPos);
+  return Hit{bestLen, best, &pool_[nodes_[best].slot * rowSize_]};
+}
+
+PrefixRowCache::Node PrefixRowCache::find(const string& prefix) const {
+  Node node = ROOT;
+  for (char c : prefix) {
+    auto it = edges_.find(edgeKey(node, static_cast<unsigned char>(c)));
+    if (it == edges_.end()) return -1;
+    node = it->second;
+  }
+  return node;
+}
+
+PrefixRowCache::Node PrefixRowCache::extend(Node prefix, char c) {
+  unsigned char uc = static_cast<unsigned char>(c);
+  auto [it, inserted] = edges_.try_emplace(edgeKey(prefix, uc), -1);
+  if (!inserted) {
+    return it->second;
+  }
+
+  Node child;
+  if (!freeNodes_.empty()) {
+    child = freeNodes_.back();
+    freeNodes_.pop_back();
+    nodes_[child] = TrieNode{};
+  } else {
+    child = static_cast<Node>(nodes_.size());
+    nodes_.emplace_back();
+  }
+  nodes_[child].parent = prefix;
+  nodes_[child].ch = uc;
+  nodes_[prefix].children++;
+  it->second = child;
+  return child;
+}
+
+void PrefixRowCache::store(Node node, const double* row) {
+  TrieNode& n = nodes_[node];
+  if (n.slot < 0) {
+    if (freeSlots_.empty()) {
+      n.slot = static_cast<int>(pool_.size() / max<size_t>(rowSize_, 1));
+      pool_.resize(pool_.size() + rowSize_);
+    } else {
+      n.slot = freeSlots_.back();
+      freeSlots_.pop_back();
+    }
+    lru_.push_front(node);
+    n.lruPos = lru_.begin();
+  } else {
+    lru_.splice(lru_.begin(), lru_, n.lruPos);
+  }
+  copy(row, row + rowSize_, pool_.begin() + n.slot * rowSize_);
+
+  // Never evict the row just stored
+  while (bytes() > maxBytes_ && lru_.size() > 1) {
+    evictOne();
+  }
+}
+
+void PrefixRowCache::evictOne() {
+  Node victim = lru_.back();
+  lru_.pop_back();
+  freeSlots_.push_back(nodes_[victim].slot);
+  nodes_[victim].slot = -1;
+  prune(victim);
+}
+
+// Remove rowless leaves from `node` upward
+void PrefixRowCache::prune(Node node) {
+  while (node != ROOT && nodes_[node].children == 0 && nodes_[node].slot < 0) {
+    Node parent = nodes_[node].parent;
+    edges_.erase(edgeKey(parent, nodes_[node].ch));
+    nodes_[parent].children--;
+    freeNodes_.push_back(node);
+    node = parent;
+  }
+}
+
+void PrefixRowCache::setMaxBytes(size_t maxBytes) {
+  maxBytes_ = maxBytes;
+  while (bytes() > maxBytes_ && !lru_.empty()) {
+    evictOne();
+  }
+}
+
+void PrefixRowCache::clear() {
+  nodes_.assign(1, TrieNode{});
+  freeNodes_.clear();
+  edges_.clear();
+  pool_.clear();
+  freeSlots_.clear();
+  lru_.clear();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// DP rows keyed by source prefix, for Levenshtein queries against a fixed
+// goal. Prefixes live in a trie, so finding the deepest cached prefix of a
+// string is one walk along it. Rows (all the same length) live in one pooled
+// buffer. Once rows and nodes exceed the byte budget, the least recently used
+// row is dropped, along with trie nodes that no longer lead to any row.
+class PrefixRowCache {
+public:
+  using Node = int;
+  static constexpr Node ROOT = 0;
+  static constexpr size_t DEFAULT_MAX_BYTES = 1 << 20;
+
+  explicit PrefixRowCache(size_t rowSize, size_t maxBytes = DEFAULT_MAX_BYTES);
+
+  struct Hit {
+    size_t length = 0;       // Prefix length
+    Node node = ROOT;        // Trie node of that prefix
+    const double* row = nullptr;  // Valid until the next store
+  };
+
+  // Deepest cached prefix of s, or an empty Hit at ROOT.
+  // Marks the row as recently used.
+  Hit deepest(const std::string& s);
+
+  // Node for prefix + c, created if needed. `prefix` must be a Hit's node,
+  // ROOT, or an earlier extend; nodes stay valid until the next store.
+  Node extend(Node prefix, char c);
+
+  // Cache `row` (rowSize values) for the prefix ending at `node`
+  void store(Node node, const double* row);
+
+  void setMaxBytes(size_t maxBytes);
+  void clear();
+
+  size_t bytes() const;
+  size_t rows() const { return lru_.size(); }
+
+  // Walk to the node for `prefix`, or -1 if not in the trie
+  Node find(const std::string& prefix) const;
+
+private:
+  struct TrieNode {
+    Node parent = -1;
+    unsigned char ch = 0;
+    int children = 0;
+    int slot = -1;  // row slot in pool_, or -1
+    std::list<Node>::iterator lruPos;
+  };
+
+  size_t rowSize_;
+  size_t maxBytes_;
+  std::vector<TrieNode> nodes_;
+  std::vector<Node> freeNodes_;
+  std::unordered_map<uint64_t, Node> edges_;  // (parent, char) -> child
+  std::vector<double> pool_;
+  std::vector<int> freeSlots_;
+  std::list<Node> lru_;  // nodes with rows, front = most recently used
+
+  static uint64_t edgeKey(Node parent, unsigned char c) {
+    return (static_cast<uint64_t>(parent) << 8) | c;
+  }
+
+  size_t liveNodes() const { return nodes_.size() - freeNodes_.size(); }
+  void evictOne();
+  void prune(Node node);
+};
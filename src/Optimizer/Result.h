@@ -6,6 +6,8 @@
 #include <vector>
 
 #include "Editor/Position.h"
+#include "Keyboard/KeyboardModel.h"
+#include "State/RunningEffort.h"
 #include "State/Sequence.h"
 #include "Utils/StringUtils.h"
 
@@ -13,6 +15,12 @@ struct Result {
   std::vector<Sequence> sequences;
   double keyCost;
 
+  // Keys of the whole sequence and the RunningEffort after typing them from a
+  // fresh start, when the producing search kept them. Both are empty for
+  // results built from a string alone.
+  PhysicalKeys physicalKeys;
+  RunningEffort standaloneEffort;
+
   Result() : keyCost(0) {}
   Result(std::vector<Sequence> seqs, double c) : sequences(std::move(seqs)), keyCost(c) {}
 
@@ -23,10 +31,21 @@ struct Result {
     }
   }
 
+  Result(const std::string& s, const PhysicalKeys& keys, const RunningEffort& standalone,
+         const Config& config)
+      : Result(s, standalone.getEffort(config)) {
+    physicalKeys = keys;
+    standaloneEffort = standalone;
+  }
+
   bool isValid() const {
     return !sequences.empty();
   }
 
+  bool hasPhysicalKeys() const {
+    return !physicalKeys.empty() || sequences.empty();
+  }
+
   // Get flattened string representation
   std::string getSequenceString() const {
     return flattenSequences(sequences);
@@ -57,6 +76,9 @@ struct RangeResult {
   double keyCost;
   Position endPos;
 
+  // Keys of the whole sequence, when the producing search kept them
+  PhysicalKeys physicalKeys;
+
   RangeResult() : keyCost(0), endPos(0, 0) {}
   RangeResult(std::vector<Sequence> seqs, double c, Position p)
     : sequences(std::move(seqs)), keyCost(c), endPos(p) {}
@@ -68,10 +90,19 @@ struct RangeResult {
     }
   }
 
+  RangeResult(const std::string& s, const PhysicalKeys& keys, double c, Position p)
+      : RangeResult(s, c, p) {
+    physicalKeys = keys;
+  }
+
   bool isValid() const {
     return !sequences.empty();
   }
 
+  bool hasPhysicalKeys() const {
+    return !physicalKeys.empty() || sequences.empty();
+  }
+
   std::string getSequenceString() const {
     return flattenSequences(sequences);
   }
@@ -0,0 +1,181 @@
+#include "ResultCache.h"
+
+#include <bit>
+
+using namespace std;
+
+namespace {
+
+// FNV-1a, 64 bit
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+uint64_t fnv(uint64_t h, const void* data, size_t len) {
+  const auto* p = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < len; i++) {
+    h ^= p[i];
+    h *= FNV_PRIME;
+  }
+  return h;
+}
+
+template <typename T>
+uint64_t fnvValue(uint64_t h, const T& value) {
+  return fnv(h, &value, sizeof(value));
+}
+
+void combine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+uint64_t hashLines(const vector<string>& lines) {
+  uint64_t h = fnvValue(FNV_OFFSET, lines.size());
+  for (const string& line : lines) {
+    // Length prefix keeps {"ab", "c"} and {"a", "bc"} apart
+    h = fnvValue(h, line.size());
+    h = fnv(h, line.data(), line.size());
+  }
+  return h;
+}
+
+uint64_t hashConfig(const Config& config) {
+  uint64_t h = FNV_OFFSET;
+  for (const KeyInfo& info : config.keyInfo) {
+    h = fnvValue(h, info.hand);
+    h = fnvValue(h, info.finger);
+    h = fnvValue(h, bit_cast<uint64_t>(info.base_cost));
+  }
+  const ScoreWeights& w = config.weights;
+  for (double weight : {w.w_key, w.w_same_finger, w.w_same_key, w.w_alt_bonus,
+                        w.w_run_pen, w.w_roll_good, w.w_roll_bad}) {
+    h = fnvValue(h, bit_cast<uint64_t>(weight));
+  }
+  return h;
+}
+
+ResultCacheKey::ResultCacheKey(const vector<string>& lines,
+                               const Position& startPos,
+                               const Position& endPos,
+                               const string& userSequence,
+                               const NavContext& navContext,
+                               const Config& config,
+                               const OptimizerParams& params,
+                               const ImpliedExclusions& impliedExclusions)
+    : bufferHash(hashLines(lines)),
+      configHash(hashConfig(config)),
+      startLine(startPos.line), startCol(startPos.col),
+      endLine(endPos.line), endCol(endPos.col),
+      userSequence(userSequence),
+      windowHeight(navContext.windowHeight), scrollAmount(navContext.scrollAmount),
+      maxResults(params.maxResults), maxSearchDepth(params.maxSearchDepth),
+      fMotionThreshold(params.fMotionThreshold),
+      costWeight(params.costWeight), exploreFactor(params.exploreFactor),
+      excludeG(impliedExclusions.exclude_G), excludeGg(impliedExclusions.exclude_gg) {}
+
+size_t ResultCacheKeyHash::operator()(const ResultCacheKey& k) const {
+  size_t h = k.bufferHash;
+  combine(h, k.configHash);
+  combine(h, hash<string>{}(k.userSequence));
+  for (int v : {k.startLine, k.startCol, k.endLine, k.endCol, k.windowHeight,
+                k.scrollAmount, k.maxResults, k.maxSearchDepth, k.fMotionThreshold}) {
+    combine(h, static_cast<size_t>(v));
+  }
+  combine(h, bit_cast<uint64_t>(k.costWeight));
+  combine(h, bit_cast<uint64_t>(k.exploreFactor));
+  combine(h, (k.excludeG ? 1 : 0) | (k.excludeGg ? 2 : 0));
+  return h;
+}
+
+size_t ResultCache::estimateBytes(const ResultCacheKey& key, const CachedSearch& value) {
+  // Entry + list node + hash node, plus heap allocations we know about
+  size_t bytes = sizeof(Entry) + 4 * sizeof(void*) + sizeof(ResultCacheKey);
+  bytes += 2 * key.userSequence.capacity();
+  bytes += value.results.capacity() * sizeof(Result);
+  for (const Result& r : value.results) {
+    bytes += r.sequences.capacity() * sizeof(Sequence);
+    for (const Sequence& s : r.sequences) {
+      bytes += s.keys.capacity();
+    }
+  }
+  return bytes;
+}
+
+void ResultCache::evictToFit(size_t budget) {
+  while (bytes_ > budget && !lru_.empty()) {
+    const Entry& victim = lru_.back();
+    bytes_ -= victim.bytes;
+    index_.erase(victim.key);
+    lru_.pop_back();
+  }
+}
+
+optional<CachedSearch> ResultCache::find(const ResultCacheKey& key) {
+  lock_guard lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    misses_++;
+    return nullopt;
+  }
+  hits_++;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->value;
+}
+
+void ResultCache::insert(const ResultCacheKey& key, CachedSearch value) {
+  size_t entryBytes = estimateBytes(key, value);
+
+  lock_guard lock(mutex_);
+  if (auto it = index_.find(key); it != index_.end()) {
+    bytes_ -= it->second->bytes;
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  if (entryBytes > maxBytes_) {
+    return;
+  }
+  evictToFit(maxBytes_ - entryBytes);
+
+  lru_.push_front(Entry{key, std::move(value), entryBytes});
+  index_.emplace(lru_.front().key, lru_.begin());
+  bytes_ += entryBytes;
+}
+
+void ResultCache::setMaxBytes(size_t maxBytes) {
+  lock_guard lock(mutex_);
+  maxBytes_ = maxBytes;
+  evictToFit(maxBytes_);
+}
+
+void ResultCache::clear() {
+  lock_guard lock(mutex_);
+  lru_.clear();
+  index_.clear();
+  bytes_ = 0;
+}
+
+size_t ResultCache::maxBytes() const {
+  lock_guard lock(mutex_);
+  return maxBytes_;
+}
+
+size_t ResultCache::bytes() const {
+  lock_guard lock(mutex_);
+  return bytes_;
+}
+
+size_t ResultCache::size() const {
+  lock_guard lock(mutex_);
+  return lru_.size();
+}
+
+uint64_t ResultCache::hits() const {
+  lock_guard lock(mutex_);
+  return hits_;
+}
+
+uint64_t ResultCache::misses() const {
+  lock_guard lock(mutex_);
+  return misses_;
+}
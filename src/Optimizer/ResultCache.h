@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Config.h"
+#include "ImpliedExclusions.h"
+#include "OptimizerParams.h"
+#include "Result.h"
+#include "Editor/NavContext.h"
+#include "Editor/Position.h"
+
+// Everything a movement search's output depends on. Buffer and config are
+// reduced to 64-bit hashes, so a collision can return a stale result; at 64
+// bits that is acceptable for an interactive tool.
+struct ResultCacheKey {
+  uint64_t bufferHash = 0;
+  uint64_t configHash = 0;
+  int startLine = 0, startCol = 0;
+  int endLine = 0, endCol = 0;
+  std::string userSequence;
+  int windowHeight = 0, scrollAmount = 0;
+  int maxResults = 0, maxSearchDepth = 0, fMotionThreshold = 0;
+  double costWeight = 0.0, exploreFactor = 0.0;
+  bool excludeG = false, excludeGg = false;
+
+  ResultCacheKey() = default;
+  ResultCacheKey(const std::vector<std::string>& lines,
+                 const Position& startPos,
+                 const Position& endPos,
+                 const std::string& userSequence,
+                 const NavContext& navContext,
+                 const Config& config,
+                 const OptimizerParams& params,
+                 const ImpliedExclusions& impliedExclusions);
+
+  bool operator==(const ResultCacheKey& other) const = default;
+};
+
+struct ResultCacheKeyHash {
+  size_t operator()(const ResultCacheKey& k) const;
+};
+
+uint64_t hashLines(const std::vector<std::string>& lines);
+uint64_t hashConfig(const Config& config);
+
+struct CachedSearch {
+  std::vector<Result> results;
+  SearchStats stats;
+};
+
+// Thread-safe LRU cache of search results, bounded by an estimate of the
+// memory its entries hold. Entries larger than the whole budget are not stored.
+class ResultCache {
+  struct Entry {
+    ResultCacheKey key;
+    CachedSearch value;
+    size_t bytes;
+  };
+
+  mutable std::mutex mutex_;
+  std::list<Entry> lru_; // front = most recently used
+  std::unordered_map<ResultCacheKey, std::list<Entry>::iterator, ResultCacheKeyHash> index_;
+  size_t maxBytes_;
+  size_t bytes_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+
+  void evictToFit(size_t budget);
+
+public:
+  static constexpr size_t DEFAULT_MAX_BYTES = 4 * 1024 * 1024;
+
+  explicit ResultCache(size_t maxBytes = DEFAULT_MAX_BYTES) : maxBytes_(maxBytes) {}
+
+  // Counts a hit or a miss
+  std::optional<CachedSearch> find(const ResultCacheKey& key);
+  void insert(const ResultCacheKey& key, CachedSearch value);
+
+  void setMaxBytes(size_t maxBytes);
+  void clear();
+
+  size_t maxBytes() const;
+  size_t bytes() const;
+  size_t size() const;
+  uint64_t hits() const;
+  uint64_t misses() const;
+
+  static size_t estimateBytes(const ResultCacheKey& key, const CachedSearch& value);
+};
@@ -7,6 +7,7 @@
 #include "Editor/Position.h"
 #include "Keyboard/KeyboardModel.h"
 #include "Keyboard/MotionToKeys.h"
+#include "Optimizer/Result.h"
 #include "RunningEffort.h"
 #include "Sequence.h"
 
@@ -66,11 +67,15 @@ class CompositionState {
   RunningEffort runningEffort;
 
   // Helper to append to the appropriate mode segment
-  void appendSequence(const std::string& s, const PhysicalKeys& keys, const Config& config) {
+  void appendKeys(const std::string& s) {
     if (sequences.empty() || sequences.back().mode != mode) {
       sequences.emplace_back(mode);
     }
     sequences.back().append(s);
+  }
+
+  void appendSequence(const std::string& s, const PhysicalKeys& keys, const Config& config) {
+    appendKeys(s);
     effort = runningEffort.append(keys, config);
   }
 
@@ -118,33 +123,41 @@ public:
   }
 
   // Apply an edit transition (uses pre-computed EditResult)
-  // - editSequences: the sequences for this edit (from EditResult.adj)
+  // - edit: the result for this edit (from EditResult.adj)
   // - newPos: position after edit completes (end position in edit region)
   // - newMode: mode after edit completes
-  void applyEditTransition(const std::vector<Sequence>& editSequences,
-                           const Position& newPos, Mode newMode,
+  // Keys kept by the edit search are appended as they are; only the seam
+  // between our last keys and the edit's first keys is re-scored.
+  void applyEditTransition(const Result& edit, const Position& newPos, Mode newMode,
                            const Config& config) {
     pos = newPos;
     editsCompleted++;
     // Merge edit sequences into our sequences
-    for (const auto& seq : editSequences) {
+    for (const auto& seq : edit.sequences) {
       // Set mode to match each segment's mode before appending
       mode = seq.mode;
-      PhysicalKeys keys = globalTokenizer().tokenize(seq.keys);
-      appendSequence(seq.keys, keys, config);
+      appendKeys(seq.keys);
+    }
+    if (edit.hasPhysicalKeys()) {
+      effort = runningEffort.appendKnown(edit.physicalKeys, edit.standaloneEffort, config);
+    } else {
+      effort = runningEffort.append(globalTokenizer().tokenize(edit.getSequenceString()), config);
     }
     mode = newMode;
   }
 
   // Apply movement result from MovementOptimizer::optimizeToRange()
-  // - moveSequences: the sequences for this movement
-  // - newPos: position after movement completes
-  void applyMovementResult(const std::vector<Sequence>& moveSequences,
-                           const Position& newPos, const Config& config) {
-    pos = newPos;
-    for (const auto& seq : moveSequences) {
-      PhysicalKeys keys = globalTokenizer().tokenize(seq.keys);
-      appendSequence(seq.keys, keys, config);
+  // The result's keys were scored from a different running effort, so they
+  // are replayed, but not re-tokenized.
+  void applyMovementResult(const RangeResult& movement, const Config& config) {
+    pos = movement.endPos;
+    for (const auto& seq : movement.sequences) {
+      appendKeys(seq.keys);
+    }
+    if (movement.hasPhysicalKeys()) {
+      effort = runningEffort.append(movement.physicalKeys, config);
+    } else {
+      effort = runningEffort.append(globalTokenizer().tokenize(movement.getSequenceString()), config);
     }
   }
 
@@ -35,6 +35,7 @@ void MotionState::applyMotionWithKnownPosition(std::string motion, int cnt, cons
 
 // TODO: combine with applySingleMotion
 void MotionState::updateEffort(const PhysicalKeys& keys, const Config& config) {
+  physicalKeys.append(keys);
   effort = runningEffort.append(keys, config);
 }
 
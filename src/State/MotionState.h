@@ -18,6 +18,7 @@ class MotionState {
 
   // Progress so far
   std::string motionSequence;
+  PhysicalKeys physicalKeys;  // Keys of motionSequence, as passed to updateEffort
 
   // Necessary for ranking states
   double effort;
@@ -49,6 +50,7 @@ public:
   Position getPos()                const { return pos; }
   Mode getMode()                   const { return mode; }
   std::string getMotionSequence()  const { return motionSequence; }
+  const PhysicalKeys& getPhysicalKeys() const { return physicalKeys; }
   double getEffort()               const { return effort; }
   double getCost()                 const { return cost; }
   RunningEffort getRunningEffort() const { return runningEffort; }
@@ -27,6 +27,48 @@ double RunningEffort::append(const PhysicalKeys& keys, const Config& model) {
   return getEffort(model);
 }
 
+// Keys only interact with the keys right before them (last key/finger/hand)
+// and with the current same-hand run. Replay `keys` both after this and from
+// a fresh start until the two memories agree; from there on every key adds
+// the same amount to both, so the rest is standalone minus the replayed head.
+double RunningEffort::appendKnown(const PhysicalKeys& keys, const RunningEffort& standalone,
+                                  const Config& model) {
+  RunningEffort head;
+  size_t replayed = 0;
+  for (Key k : keys) {
+    appendSingle(k, model);
+    head.appendSingle(k, model);
+    replayed++;
+    if (sameMemory(head)) break;
+  }
+  if (replayed == keys.size()) {
+    return getEffort(model);
+  }
+
+  strokes         += standalone.strokes         - head.strokes;
+  sum_key_cost    += standalone.sum_key_cost    - head.sum_key_cost;
+  sum_same_finger += standalone.sum_same_finger - head.sum_same_finger;
+  sum_same_key    += standalone.sum_same_key    - head.sum_same_key;
+  sum_alt_bonus   += standalone.sum_alt_bonus   - head.sum_alt_bonus;
+  sum_run_pen     += standalone.sum_run_pen     - head.sum_run_pen;
+  sum_roll_good   += standalone.sum_roll_good   - head.sum_roll_good;
+  sum_roll_bad    += standalone.sum_roll_bad    - head.sum_roll_bad;
+
+  last_key    = standalone.last_key;
+  last_finger = standalone.last_finger;
+  last_hand   = standalone.last_hand;
+  prev_finger = standalone.prev_finger;
+  run_hand    = standalone.run_hand;
+  run_len     = standalone.run_len;
+  return getEffort(model);
+}
+
+bool RunningEffort::sameMemory(const RunningEffort& other) const {
+  return last_key == other.last_key && last_finger == other.last_finger
+      && last_hand == other.last_hand && run_hand == other.run_hand
+      && run_len == other.run_len;
+}
+
 // Append a key index [0..KEY_COUNT-1] and update all metrics.
 void RunningEffort::appendSingle(Key key, const Config &model) {
   const KeyInfo &km = model.keyInfo[static_cast<uint8_t>(key)];
@@ -32,11 +32,26 @@ private:
   // Append a key index [0..KEY_COUNT-1] and update all metrics.
   void appendSingle(Key key, const Config &model);
 
+  // Whether the next key would be scored the same after both
+  bool sameMemory(const RunningEffort& other) const;
+
 public:
   double getEffort(const Config &model) const;
 
+  // Everything besides the config that the cost of further keys depends on:
+  // the last key and the length of the current same-hand run. Two efforts
+  // with equal context grow by the same amount for the same keys.
+  uint32_t typingContext() const {
+    return (static_cast<uint32_t>(last_key) << 16) | static_cast<uint32_t>(std::min(run_len, 0xffff));
+  }
+
   double append(const PhysicalKeys& keys, const Config& model);
 
+  // Same result as append(keys), where `standalone` is a fresh RunningEffort
+  // after append(keys). Only the keys at the seam are replayed.
+  double appendKnown(const PhysicalKeys& keys, const RunningEffort& standalone,
+                     const Config& model);
+
   void reset();
 };
 
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+#include "Lines.h"
+
+// Order-sensitive 64-bit fingerprint of a buffer: the sum of each line's hash
+// weighted by BASE^position (mod 2^64). BASE is odd, so it has an inverse and
+// an edit swaps only the changed lines' terms, rescaling one side of them when
+// the line count changes. Finding the changed lines still compares the buffers
+// line by line, which costs no more than the copy the edit was made on.
+class BufferFingerprint {
+  static constexpr uint64_t BASE = 0x100000001b3ull;
+
+  uint64_t sum = 0;
+  size_t lineCount = 0;
+
+  // splitmix64 finalizer
+  static uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+  }
+
+  static uint64_t hashLine(const std::string& line) {
+    return mix(std::hash<std::string_view>{}(line) + line.size());
+  }
+
+  static constexpr uint64_t inverse(uint64_t x) {
+    // Newton's iteration, each step doubles the correct low bits (x*x == 1 mod 8)
+    uint64_t inv = x;
+    for (int i = 0; i < 5; i++) {
+      inv *= 2 - x * inv;
+    }
+    return inv;
+  }
+
+  static uint64_t power(uint64_t x, size_t n) {
+    uint64_t result = 1;
+    for (; n > 0; n >>= 1) {
+      if (n & 1) result *= x;
+      x *= x;
+    }
+    return result;
+  }
+
+  // Weighted hashes of lines[first, last), the first one weighted by `weight`
+  static uint64_t terms(const Lines& lines, size_t first, size_t last, uint64_t weight) {
+    uint64_t total = 0;
+    for (size_t i = first; i < last; i++) {
+      total += hashLine(lines[i]) * weight;
+      weight *= BASE;
+    }
+    return total;
+  }
+
+public:
+  BufferFingerprint() = default;
+
+  explicit BufferFingerprint(const Lines& lines)
+      : sum(terms(lines, 0, lines.size(), 1)), lineCount(lines.size()) {}
+
+  // Fingerprint of `after`, where this is the fingerprint of `before`.
+  // Rehashes the changed lines, plus the shorter of the unchanged prefix and
+  // suffix when the line count changes.
+  BufferFingerprint updated(const Lines& before, const Lines& after) const {
+    size_t common = std::min(before.size(), after.size());
+    size_t prefix = 0;
+    while (prefix < common && before[prefix] == after[prefix]) {
+      prefix++;
+    }
+    size_t suffix = 0;
+    while (suffix < common - prefix
+           && before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix]) {
+      suffix++;
+    }
+
+    size_t beforeEnd = before.size() - suffix;
+    size_t afterEnd = after.size() - suffix;
+    uint64_t prefixWeight = power(BASE, prefix);
+    uint64_t removed = terms(before, prefix, beforeEnd, prefixWeight);
+    uint64_t added = terms(after, prefix, afterEnd, prefixWeight);
+
+    BufferFingerprint result;
+    result.lineCount = after.size();
+    if (before.size() == after.size()) {
+      result.sum = sum - removed + added;
+      return result;
+    }
+
+    // The suffix moves by the change in line count, so its terms are rescaled
+    uint64_t suffixTerms;
+    if (prefix < suffix) {
+      suffixTerms = sum - terms(before, 0, prefix, 1) - removed;
+    } else {
+      suffixTerms = terms(before, beforeEnd, before.size(), power(BASE, beforeEnd));
+    }
+    uint64_t shift = after.size() > before.size()
+        ? power(BASE, after.size() - before.size())
+        : power(inverse(BASE), before.size() - after.size());
+    result.sum = sum - removed - suffixTerms + added + suffixTerms * shift;
+    return result;
+  }
+
+  uint64_t value() const { return mix(sum + mix(lineCount)); }
+};
+
+using SharedFingerprint = std::shared_ptr<const BufferFingerprint>;
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+// Cooperative cancellation flag shared between the thread that owns a job and
+// the thread running it. Copies share the same flag, so a token can be stored
+// in OptimizerParams and checked from inside the search loops.
+// A default constructed token has no flag and can never be cancelled.
+class CancellationToken {
+  std::shared_ptr<std::atomic<bool>> flag;
+
+public:
+  CancellationToken() = default;
+
+  static CancellationToken create() {
+    CancellationToken token;
+    token.flag = std::make_shared<std::atomic<bool>>(false);
+    return token;
+  }
+
+  void cancel() const {
+    if (flag) {
+      flag->store(true, std::memory_order_relaxed);
+    }
+  }
+
+  bool isCancelled() const {
+    return flag && flag->load(std::memory_order_relaxed);
+  }
+};
@@ -10,8 +10,9 @@ constexpr bool DEBUG_ENABLED = true;
 constexpr bool DEBUG_ENABLED = false;
 #endif
 
+// Per thread, so searches running on worker threads don't interleave output.
 inline std::ostringstream& dout() {
-    static std::ostringstream stream;
+    thread_local std::ostringstream stream;
     return stream;
 }
 
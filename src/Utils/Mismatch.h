@@ -0,0 +1,58 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Length of the common prefix of a[0, n) and b[0, n).
+// Compares 32 (AVX2) or 16 (SSE2) bytes per step where available, else 8
+// bytes per word, with a byte-wise tail. Short runs stay on the scalar path.
+inline size_t mismatchLength(const char* a, const char* b, size_t n) {
+  size_t i = 0;
+  // Most snakes end within a few bytes; don't pay for a vector load then
+  while (i < n && i < 4) {
+    if (a[i] != b[i]) return i;
+    i++;
+  }
+#if defined(__AVX2__)
+  for (; i + 32 <= n; i += 32) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    uint32_t equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+    if (equal != 0xffffffffu) return i + std::countr_one(equal);
+  }
+#endif
+#if defined(__SSE2__)
+  for (; i + 16 <= n; i += 16) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    uint32_t equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+    if (equal != 0xffffu) return i + std::countr_one(equal);
+  }
+#else
+  for (; i + 8 <= n; i += 8) {
+    uint64_t wa;
+    uint64_t wb;
+    std::memcpy(&wa, a + i, 8);
+    std::memcpy(&wb, b + i, 8);
+    if (wa != wb) {
+      uint64_t diff = wa ^ wb;
+      int bit = std::endian::native == std::endian::little ? std::countr_zero(diff)
+                                                           : std::countl_zero(diff);
+      return i + bit / 8;
+    }
+  }
+#endif
+  while (i < n && a[i] == b[i]) {
+    i++;
+  }
+  return i;
+}
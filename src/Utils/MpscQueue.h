@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// Unbounded lock-free queue for many producers and a single consumer
+// (Vyukov's intrusive MPSC list). push() is one atomic exchange; pop() never
+// blocks, and may report empty while a push is halfway done, so callers that
+// need to know the queue is drained must count pushes themselves.
+template <typename T>
+class MpscQueue {
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    std::optional<T> value;
+  };
+
+  std::atomic<Node*> head_;  // last pushed node, swapped by producers
+  Node* tail_;               // consumer's stub; its successor is the front
+
+public:
+  MpscQueue() {
+    Node* stub = new Node;
+    head_.store(stub, std::memory_order_relaxed);
+    tail_ = stub;
+  }
+
+  ~MpscQueue() {
+    while (tail_) {
+      Node* next = tail_->next.load(std::memory_order_relaxed);
+      delete tail_;
+      tail_ = next;
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // Any thread
+  void push(T value) {
+    Node* node = new Node;
+    node->value.emplace(std::move(value));
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Consumer thread only
+  std::optional<T> pop() {
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (!next) {
+      return std::nullopt;
+    }
+    std::optional<T> value = std::move(next->value);
+    next->value.reset();
+    delete tail_;
+    tail_ = next;
+    return value;
+  }
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+#include "TaskScheduler.h"
+
+// Runs body(i) for every i in [0, count) on up to `threads` threads, the
+// calling thread included. The other threads are tasks on the shared
+// TaskScheduler, so nested calls and concurrent optimizers share its workers
+// instead of starting their own. Threads claim the next unstarted index as
+// they free up, so a few slow items don't hold back a fixed split.
+// Writing results to slot i keeps output order independent of scheduling.
+// The first exception thrown by body is rethrown once all threads stop.
+template <typename Body>
+void parallelFor(size_t count, unsigned threads, Body&& body,
+                 TaskScheduler& scheduler = TaskScheduler::shared()) {
+  size_t workers = std::min<size_t>(std::max(1u, threads), count);
+  if (workers <= 1) {
+    for (size_t i = 0; i < count; i++) {
+      body(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next{0};
+  TaskGroup group(scheduler);
+
+  auto work = [&] {
+    size_t i;
+    while (!group.isCancelled() && (i = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+      body(i);
+    }
+  };
+
+  for (size_t t = 1; t < workers; t++) {
+    group.run(work);
+  }
+  try {
+    work();
+  } catch (...) {
+    group.cancel();
+    group.wait();  // Tasks still reference this frame
+    throw;
+  }
+  group.wait();
+}
@@ -0,0 +1,186 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "Debug.h"
+
+namespace {
+
+// Set on the scheduler's own threads, so forks go to their deque
+thread_local TaskScheduler* currentScheduler = nullptr;
+thread_local int currentWorker = -1;
+
+// Failed searches before a worker sleeps
+constexpr int SPINS_BEFORE_SLEEP = 64;
+
+} // namespace
+
+TaskScheduler::TaskScheduler(unsigned threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+  }
+  threads = std::max(1u, threads);
+  for (unsigned i = 0; i < threads; i++) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+  // Start only once every deque exists, since workers steal from all of them
+  for (unsigned i = 0; i < threads; i++) {
+    workers[i]->thread = std::jthread([this, i] { workerLoop(static_cast<int>(i)); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& worker : workers) {
+    worker->thread.join();
+  }
+  // Groups wait for their tasks, so nothing should be left queued
+}
+
+TaskScheduler& TaskScheduler::shared() {
+  static TaskScheduler scheduler;
+  return scheduler;
+}
+
+void TaskScheduler::submit(Task* task) {
+  if (currentScheduler == this) {
+    workers[currentWorker]->deque.push(task);
+  } else {
+    std::lock_guard lock(injectMutex);
+    injected.push_back(task);
+  }
+
+  epoch.fetch_add(1);
+  if (sleepers.load() > 0) {
+    std::lock_guard lock(sleepMutex);
+    wake.notify_one();
+  }
+}
+
+TaskScheduler::Task* TaskScheduler::findTask(int self) {
+  if (self >= 0) {
+    if (std::optional<Task*> task = workers[self]->deque.pop()) {
+      return *task;
+    }
+  }
+  {
+    std::lock_guard lock(injectMutex);
+    if (!injected.empty()) {
+      Task* task = injected.front();
+      injected.pop_front();
+      return task;
+    }
+  }
+  // Steal, starting after ourselves so thieves spread over victims
+  int n = static_cast<int>(workers.size());
+  for (int k = 1; k <= n; k++) {
+    int victim = (std::max(self, 0) + k) % n;
+    if (victim == self) continue;
+    if (std::optional<Task*> task = workers[victim]->deque.steal()) {
+      return *task;
+    }
+  }
+  return nullptr;
+}
+
+void TaskScheduler::execute(Task* task) {
+  std::unique_ptr<Task> owned(task);
+  TaskGroup* group = task->group;
+  std::exception_ptr thrown;
+  std::ostringstream output;
+  if (!group->isCancelled()) {
+    // The task writes to a fresh stream, handed to the group afterwards
+    if constexpr (DEBUG_ENABLED) output.swap(dout());
+    try {
+      task->fn();
+    } catch (...) {
+      thrown = std::current_exception();
+    }
+    if constexpr (DEBUG_ENABLED) output.swap(dout());
+  }
+  owned.reset();
+  group->finish(thrown, output.str());
+}
+
+void TaskScheduler::workerLoop(int self) {
+  currentScheduler = this;
+  currentWorker = self;
+  int idle = 0;
+  while (!stopping.load(std::memory_order_relaxed)) {
+    uint64_t seen = epoch.load();
+    if (Task* task = findTask(self)) {
+      execute(task);
+      idle = 0;
+      continue;
+    }
+    if (++idle < SPINS_BEFORE_SLEEP) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock lock(sleepMutex);
+    sleepers.fetch_add(1);
+    wake.wait(lock, [&] { return stopping.load() || epoch.load() != seen; });
+    sleepers.fetch_sub(1);
+    idle = 0;
+  }
+}
+
+bool TaskScheduler::runOne() {
+  Task* task = findTask(currentScheduler == this ? currentWorker : -1);
+  if (!task) {
+    return false;
+  }
+  execute(task);
+  return true;
+}
+
+void TaskGroup::finish(std::exception_ptr thrown, const std::string& output) {
+  if (thrown || !output.empty()) {
+    std::lock_guard lock(errorMutex);
+    debugOutput += output;
+    if (thrown && !error) {
+      error = thrown;
+    }
+  }
+  if (thrown) {
+    cancel_.cancel();
+  }
+  pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void TaskGroup::join() {
+  while (pending.load(std::memory_order_acquire) > 0) {
+    if (!scheduler.runOne()) {
+      std::this_thread::yield();
+    }
+  }
+  std::lock_guard lock(errorMutex);
+  if (!debugOutput.empty()) {
+    dout() << debugOutput;
+    debugOutput.clear();
+  }
+}
+
+TaskGroup::~TaskGroup() {
+  join();
+}
+
+void TaskGroup::run(std::function<void()> fn) {
+  pending.fetch_add(1, std::memory_order_relaxed);
+  scheduler.submit(new TaskScheduler::Task{std::move(fn), this});
+}
+
+void TaskGroup::wait() {
+  join();
+  std::lock_guard lock(errorMutex);
+  if (error) {
+    std::exception_ptr thrown = error;
+    error = nullptr;
+    std::rethrow_exception(thrown);
+  }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "WorkStealingDeque.h"
+
+class TaskGroup;
+
+// Work-stealing scheduler: a fixed set of worker threads, each with its own
+// Chase-Lev deque. Tasks forked on a worker go to its deque, others to a
+// shared injection queue; idle workers steal from the top of other deques.
+// Threads waiting on a TaskGroup run queued tasks meanwhile, so nested fork
+// and join never needs more threads than the scheduler has.
+class TaskScheduler {
+  friend class TaskGroup;
+
+  struct Task {
+    std::function<void()> fn;
+    TaskGroup* group;
+  };
+
+  struct Worker {
+    WorkStealingDeque<Task*> deque;
+    std::jthread thread;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  std::mutex injectMutex;
+  std::deque<Task*> injected;
+
+  // Sleeping: workers that found nothing wait for `epoch` to move
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  std::atomic<uint64_t> epoch{0};
+  std::atomic<int> sleepers{0};
+  std::atomic<bool> stopping{false};
+
+  void submit(Task* task);
+  Task* findTask(int self);
+  void execute(Task* task);
+  void workerLoop(int self);
+
+  // Runs one queued task, if any; for threads waiting on a group
+  bool runOne();
+
+public:
+  // `threads` workers; 0 means one per hardware thread, less the caller's
+  explicit TaskScheduler(unsigned threads = 0);
+  ~TaskScheduler();
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+  // Process-wide scheduler, shared by all optimizers
+  static TaskScheduler& shared();
+};
+
+// Tasks forked together and joined with wait(). A task that throws cancels
+// the group; wait() rethrows the first exception once every task is done.
+// Tasks of a cancelled group that have not started are skipped, and running
+// ones can poll isCancelled().
+// Debug output of the tasks is collected and appended to the debug stream of
+// the thread that waits, since workers' own streams are never read.
+class TaskGroup {
+  friend class TaskScheduler;
+
+  TaskScheduler& scheduler;
+  CancellationToken cancel_;
+  std::atomic<int> pending{0};
+  std::exception_ptr error;
+  std::string debugOutput;
+  std::mutex errorMutex;  // guards error and debugOutput
+
+  void finish(std::exception_ptr thrown, const std::string& output);
+  void join();
+
+public:
+  explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::shared(),
+                     CancellationToken cancel = CancellationToken::create())
+      : scheduler(scheduler), cancel_(std::move(cancel)) {}
+
+  // Waits for the group's tasks, but drops any exception
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void run(std::function<void()> fn);
+
+  // Runs queued tasks until this group's are done
+  void wait();
+
+  void cancel() { cancel_.cancel(); }
+  bool isCancelled() const { return cancel_.isCancelled(); }
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads consuming a FIFO task queue.
+// Tasks still queued when the pool is destroyed are dropped; running tasks are
+// joined, so they should observe a CancellationToken if they can run long.
+class ThreadPool {
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stopping = false;
+
+  void workerLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (stopping) {
+          return;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+public:
+  explicit ThreadPool(unsigned threadCount) {
+    threadCount = std::max(1u, threadCount);
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++) {
+      workers.emplace_back([this] { workerLoop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+      tasks.clear();
+    }
+    cv.notify_all();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard lock(mutex);
+      tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+  }
+
+  size_t size() const { return workers.size(); }
+};
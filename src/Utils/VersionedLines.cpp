@@ -0,0 +1,79 @@
+#include "VersionedLines.h"
+
+#include <algorithm>
+#include <memory>
+
+using namespace std;
+
+VersionedLines::VersionedLines(Lines lines, size_t maxCached)
+    : base(make_shared<const Lines>(lines)),
+      counts{static_cast<int>(lines.size())},
+      tip_(std::move(lines)),
+      maxCached(max<size_t>(maxCached, 1)) {}
+
+void VersionedLines::apply(Lines& lines, const Delta& delta) {
+  auto at = lines.begin() + delta.first;
+  int reused = min(delta.removed, static_cast<int>(delta.replacement.size()));
+  copy(delta.replacement.begin(), delta.replacement.begin() + reused, at);
+  if (delta.removed > reused) {
+    lines.erase(at + reused, at + delta.removed);
+  } else {
+    lines.insert(at + reused, delta.replacement.begin() + reused, delta.replacement.end());
+  }
+}
+
+void VersionedLines::push(int first, int removed, Lines replacement) {
+  Delta& delta = deltas.emplace_back(Delta{first, removed, std::move(replacement)});
+  apply(tip_, delta);
+  counts.push_back(static_cast<int>(tip_.size()));
+}
+
+const string& VersionedLines::line(int version, int index) const {
+  // Walk back until some version wrote this line, tracking its index
+  for (int v = version; v > 0; v--) {
+    const Delta& delta = deltas[v - 1];
+    int replaced = static_cast<int>(delta.replacement.size());
+    if (index < delta.first) {
+      continue;
+    }
+    if (index < delta.first + replaced) {
+      return delta.replacement[index - delta.first];
+    }
+    index += delta.removed - replaced;
+  }
+  return (*base)[index];
+}
+
+SharedLines VersionedLines::lines(int version) {
+  if (version == 0) {
+    return base;
+  }
+
+  // Start from the closest earlier version we already have
+  int from = 0;
+  SharedLines start = base;
+  for (auto it = cache.begin(); it != cache.end(); ++it) {
+    if (it->first == version) {
+      auto hit = *it;
+      cache.erase(it);
+      cache.push_back(hit);
+      return hit.second;
+    }
+    if (it->first < version && it->first > from) {
+      from = it->first;
+      start = it->second;
+    }
+  }
+
+  Lines materialized = *start;
+  for (int v = from + 1; v <= version; v++) {
+    apply(materialized, deltas[v - 1]);
+  }
+
+  SharedLines result = make_shared<const Lines>(std::move(materialized));
+  if (cache.size() >= maxCached) {
+    cache.erase(cache.begin());
+  }
+  cache.emplace_back(version, result);
+  return result;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Lines.h"
+
+// A sequence of buffer versions where each version after the first stores
+// only the lines it replaced in the previous one. Single lines are read
+// through the chain; motion code that needs a whole Lines gets one
+// materialized on demand, with the most recently used few kept around.
+class VersionedLines {
+  // Version v replaces `removed` lines at `first` of version v-1 with `replacement`
+  struct Delta {
+    int first;
+    int removed;
+    Lines replacement;
+  };
+
+  SharedLines base;
+  std::vector<Delta> deltas;      // deltas[v - 1] builds version v
+  std::vector<int> counts;        // Line count per version
+  Lines tip_;                     // Latest version, kept for push()
+
+  size_t maxCached;
+  std::vector<std::pair<int, SharedLines>> cache;  // Most recently used last
+
+  static void apply(Lines& lines, const Delta& delta);
+
+public:
+  explicit VersionedLines(Lines base, size_t maxCached = 4);
+
+  // Add a version: the latest one with `removed` lines at `first` replaced
+  void push(int first, int removed, Lines replacement);
+
+  // Latest version
+  const Lines& tip() const { return tip_; }
+
+  int versions() const { return static_cast<int>(counts.size()); }
+  int lineCount(int version) const { return counts[version]; }
+
+  // Line `index` of `version`, without materializing the version
+  const std::string& line(int version, int index) const;
+
+  // Whole version, shared until evicted from the cache
+  SharedLines lines(int version);
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev work-stealing deque (with the C11 orderings of Le et al.,
+// "Correct and Efficient Work-Stealing for Weak Memory Models").
+// The owner thread pushes and pops at the bottom; any thread may steal from
+// the top. T must be trivially copyable, typically a pointer.
+// The ring grows when full; outgrown rings are kept until destruction, since
+// a thief may still be reading one.
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>, "deque slots are atomics");
+
+  struct Ring {
+    int64_t capacity;
+    std::unique_ptr<std::atomic<T>[]> slots;
+
+    explicit Ring(int64_t capacity)
+        : capacity(capacity), slots(new std::atomic<T>[capacity]) {}
+
+    T get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+    void put(int64_t i, T value) { slots[i & (capacity - 1)].store(value, std::memory_order_relaxed); }
+  };
+
+  std::atomic<int64_t> top_{0};
+  std::atomic<int64_t> bottom_{0};
+  std::atomic<Ring*> ring_;
+  std::vector<std::unique_ptr<Ring>> rings_;  // owner only; rings_.back() is current
+
+  Ring* grow(Ring* old, int64_t top, int64_t bottom) {
+    auto bigger = std::make_unique<Ring>(old->capacity * 2);
+    for (int64_t i = top; i < bottom; i++) {
+      bigger->put(i, old->get(i));
+    }
+    Ring* ring = bigger.get();
+    rings_.push_back(std::move(bigger));
+    ring_.store(ring, std::memory_order_release);
+    return ring;
+  }
+
+public:
+  // capacity must be a power of two
+  explicit WorkStealingDeque(int64_t capacity = 64) {
+    rings_.push_back(std::make_unique<Ring>(capacity));
+    ring_.store(rings_.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // Owner only
+  void push(T value) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    if (b - t > ring->capacity - 1) {
+      ring = grow(ring, t, b);
+    }
+    ring->put(b, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // Owner only; takes the most recently pushed value
+  std::optional<T> pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    T value = ring->get(b);
+    if (t == b) {
+      // Last element: race the thieves for it
+      bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return std::nullopt;
+      }
+    }
+    return value;
+  }
+
+  // Any thread; takes the oldest value. Empty on contention as well.
+  std::optional<T> steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return std::nullopt;
+    }
+    Ring* ring = ring_.load(std::memory_order_acquire);
+    T value = ring->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  bool empty() const {
+    return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+  }
+};
@@ -1,5 +1,6 @@
 #include <vector>
 #include <string>
+#include <tuple>
 
 struct Position;
 
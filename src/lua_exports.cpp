@@ -1,16 +1,26 @@
 // src/lua_exports.cpp
 
+#include "lua_exports.h"
+
 #include "Editor/Motion.h"
 #include "Keyboard/KeyboardModel.h"
 #include "Keyboard/XMacroKeyDefinitions.h"
 #include "Optimizer/Config.h"
 #include "Optimizer/ImpliedExclusions.h"
 #include "Optimizer/MovementOptimizer.h"
+#include "Optimizer/ResultCache.h"
 #include "State/MotionState.h"
 #include "Utils/CoutCapture.h"
 #include "Utils/Debug.h"
+#include "Utils/TaskScheduler.h"
+#include "Utils/ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -21,36 +31,6 @@ static const char *g_hand_names[] = {VIMFICIENCY_HANDS(STRING_VALUE)};
 static const char *g_finger_names[] = {VIMFICIENCY_FINGERS(STRING_VALUE)};
 #undef STRING_VALUE
 
-enum DEFAULT_KEYBOARD {
-  NONE,
-  UNIFORM,
-  QWERTY,
-  COLEMAK_DH,
-};
-
-struct C_ScoreWeights {
-  double w_key = 1.0;
-  double w_same_finger{};
-  double w_same_key{};
-  double w_alt_bonus{};
-  double w_run_pen{};
-  double w_roll_good{};
-  double w_roll_bad{};
-};
-
-struct C_KeyInfo {
-  int8_t hand = static_cast<int8_t>(Hand::None);
-  int8_t finger = static_cast<int8_t>(Finger::None);
-  double base_cost = 0.0;
-};
-
-struct VimficiencyConfigFFI {
-  DEFAULT_KEYBOARD default_keyboard = UNIFORM;
-  C_ScoreWeights weights{};
-  C_KeyInfo keys[KEY_COUNT]{};
-  int slice_buffer_amount{};
-};
-
 // Helper to split string by newlines
 static std::vector<std::string> split_lines(const char *text) {
   std::vector<std::string> lines;
@@ -105,6 +85,174 @@ static void sync_config() {
   }
 }
 
+// Owned copy of an analysis call's arguments, so it can outlive the FFI call
+struct AnalysisRequest {
+  std::vector<std::string> lines;
+  Position startPosition;
+  Position endPosition;
+  std::string keyseq;
+  NavContext navigationContext;
+  ImpliedExclusions impliedExclusions;
+  OptimizerParams params;
+};
+
+static AnalysisRequest make_request(
+  const char *text,
+  bool includes_real_top, bool includes_real_bottom,
+  int start_row, int start_col,
+  int end_row, int end_col,
+  const char *keyseq,
+  int window_height, int scroll_amount,
+  int RESULTS_CALCULATED
+) {
+  return AnalysisRequest{
+    split_lines(text),
+    Position(start_row, start_col),
+    Position(end_row, end_col),
+    keyseq,
+    NavContext(window_height, scroll_amount),
+    // Exclude G if we DON'T have the real bottom, exclude gg if we DON'T have the real top
+    ImpliedExclusions(!includes_real_bottom, !includes_real_top),
+    OptimizerParams(RESULTS_CALCULATED),
+  };
+}
+
+struct AnalysisOutput {
+  std::vector<RangeResult> results;
+  std::string debug;
+  std::string error;
+  SearchStats stats;
+  double elapsedMs = 0.0;
+  bool cached = false;
+};
+
+// Searches, or answers from `cache` when the same query was seen before.
+// Cancelled searches are incomplete, so they are never cached.
+static AnalysisOutput run_analysis(const AnalysisRequest &request, const Config &config,
+                                   ResultCache &cache) {
+  AnalysisOutput out;
+  auto startTime = std::chrono::steady_clock::now();
+  try {
+    ResultCacheKey key(request.lines, request.startPosition, request.endPosition,
+                       request.keyseq, request.navigationContext, config,
+                       request.params, request.impliedExclusions);
+
+    std::optional<CachedSearch> search = cache.find(key);
+    out.cached = search.has_value();
+    if (!search) {
+      MovementOptimizer opt(config);
+
+      // Pass Position and fresh RunningEffort (no prior typing context from FFI)
+      std::vector<Result> res = opt.optimize(
+          request.lines, request.startPosition, RunningEffort(), request.endPosition,
+          request.keyseq, request.navigationContext, request.impliedExclusions,
+          EXPLORABLE_MOTIONS, request.params);
+
+      search = CachedSearch{std::move(res), opt.lastStats};
+      if (!search->stats.cancelled) {
+        cache.insert(key, *search);
+      }
+    }
+
+    out.results.reserve(search->results.size());
+    for (Result &r : search->results) {
+      out.results.emplace_back(std::move(r.sequences), r.keyCost, request.endPosition);
+    }
+    out.stats = search->stats;
+  } catch (const std::exception& e) {
+    out.error = std::string("ERROR: ") + e.what();
+  }
+  if constexpr (DEBUG_ENABLED) {
+    out.debug = consume_debug_output();
+  }
+  out.elapsedMs = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - startTime).count();
+  return out;
+}
+
+// Owns everything a VimficiencyResults points into
+struct ResultArena {
+  AnalysisOutput output;
+  std::vector<std::string> sequenceStrings;
+  std::vector<VimficiencySegment> segments;
+  std::vector<VimficiencyResult> results;
+  VimficiencyResults view{};
+
+  const VimficiencyResults *fill(AnalysisOutput &&newOutput) {
+    output = std::move(newOutput);
+    sequenceStrings.clear();
+    segments.clear();
+    results.clear();
+
+    // Size everything up front so the pointers handed out below stay put
+    size_t segmentCount = 0;
+    for (const RangeResult &r : output.results) {
+      segmentCount += r.sequences.size();
+    }
+    sequenceStrings.reserve(output.results.size());
+    segments.reserve(segmentCount);
+    results.reserve(output.results.size());
+
+    for (const RangeResult &r : output.results) {
+      const std::string &seq = sequenceStrings.emplace_back(r.getSequenceString());
+      size_t firstSegment = segments.size();
+      for (const Sequence &part : r.sequences) {
+        segments.push_back({static_cast<int>(part.mode), part.keys.data(), part.keys.size()});
+      }
+      results.push_back({seq.data(), seq.size(), r.keyCost, r.endPos.line, r.endPos.col,
+                         segments.data() + firstSegment, r.sequences.size()});
+    }
+
+    view.error = output.error.empty() ? nullptr : output.error.c_str();
+    view.results = results.data();
+    view.count = results.size();
+    view.debug = output.debug.data();
+    view.debug_len = output.debug.size();
+    view.stats = {output.stats.explored, output.stats.userEffort, output.elapsedMs,
+                  output.stats.cancelled, output.cached};
+    return &view;
+  }
+};
+
+// Background analysis jobs. A job stays in its handle until it is polled after
+// completion or cancelled; the worker holds its own reference meanwhile.
+struct AnalysisJob {
+  AnalysisRequest request;
+  Config config;
+  std::shared_ptr<ResultCache> cache; // Shared so it outlives a destroyed handle
+  AnalysisOutput output;
+  std::atomic<bool> done = false;
+
+  AnalysisJob(AnalysisRequest request, const Config &config,
+              std::shared_ptr<ResultCache> cache)
+      : request(std::move(request)), config(config), cache(std::move(cache)) {}
+};
+
+// Leave a core for the editor itself. Jobs still running at exit are joined
+// by ~ThreadPool and may be waiting on the shared TaskScheduler, so that is
+// created first and therefore destroyed after the pool.
+static ThreadPool &worker_pool() {
+  TaskScheduler::shared();
+  static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency() / 2));
+  return pool;
+}
+
+// Per-caller state for the analysis API. Separate handles share nothing but
+// the worker pool and the global config.
+struct VimficiencyHandle {
+  std::mutex jobsMutex;
+  std::unordered_map<int, std::shared_ptr<AnalysisJob>> jobs;
+  int nextJobId = 1;
+  ResultArena arena;
+  std::shared_ptr<ResultCache> cache = std::make_shared<ResultCache>();
+
+  ~VimficiencyHandle() {
+    for (auto &[id, job] : jobs) {
+      job->request.params.cancel.cancel();
+    }
+  }
+};
+
 extern "C" {
 // Note we need to "redefine" (export) these since original declarations are
 // constexpr, and so may be inlined / name mangled
@@ -131,7 +279,13 @@ const char *vimficiency_finger_name(int index) {
   return g_finger_names[index];
 }
 
-const char *vimficiency_analyze(
+VimficiencyHandle *vimficiency_create() { return new VimficiencyHandle(); }
+
+// Cancels the handle's outstanding jobs. Their workers finish in the background.
+void vimficiency_destroy(VimficiencyHandle *handle) { delete handle; }
+
+const VimficiencyResults *vimficiency_analyze(
+  VimficiencyHandle *handle,
   const char *text,
   bool includes_real_top, bool includes_real_bottom,
   int start_row, int start_col,
@@ -142,45 +296,96 @@ const char *vimficiency_analyze(
   // How many results to calculate/return
   int RESULTS_CALCULATED
 ) {
-  static std::string result_storage;
-
-  try {
-    auto lines = split_lines(text);
-
-    Position start_position(start_row, start_col);
-    Position end_position(end_row, end_col);
-
-    NavContext navigation_context(window_height, scroll_amount);
-    // Exclude G if we DON'T have the real bottom, exclude gg if we DON'T have the real top
-    ImpliedExclusions impliedExclusions(!includes_real_bottom, !includes_real_top);
-
-    // g_config_internal was already populated by vimficiency_apply_config()
-    MovementOptimizer opt(g_config_internal);
+  AnalysisRequest request = make_request(
+      text, includes_real_top, includes_real_bottom, start_row, start_col,
+      end_row, end_col, keyseq, window_height, scroll_amount, RESULTS_CALCULATED);
+  return handle->arena.fill(run_analysis(request, g_config_internal, *handle->cache));
+}
 
-    // Pass Position and fresh RunningEffort (no prior typing context from FFI)
-    std::vector<Result> res = opt.optimize(lines, start_position, RunningEffort(), end_position, keyseq, navigation_context, impliedExclusions, EXPLORABLE_MOTIONS, OptimizerParams(RESULTS_CALCULATED));
+// Same arguments as vimficiency_analyze, but the search runs on a worker
+// thread. Returns a job id (> 0) to pass to vimficiency_poll/vimficiency_cancel.
+int vimficiency_submit(
+  VimficiencyHandle *handle,
+  const char *text,
+  bool includes_real_top, bool includes_real_bottom,
+  int start_row, int start_col,
+  int end_row, int end_col,
+  const char *keyseq,
+  [[maybe_unused]] int top_row, [[maybe_unused]] int bottom_row,
+  int window_height, int scroll_amount,
+  int RESULTS_CALCULATED
+) {
+  // Snapshot config so a later vimficiency_apply_config can't race the worker
+  auto job = std::make_shared<AnalysisJob>(
+      make_request(text, includes_real_top, includes_real_bottom, start_row,
+                   start_col, end_row, end_col, keyseq, window_height,
+                   scroll_amount, RESULTS_CALCULATED),
+      g_config_internal, handle->cache);
+  job->request.params.cancel = CancellationToken::create();
+
+  int id;
+  {
+    std::lock_guard lock(handle->jobsMutex);
+    id = handle->nextJobId++;
+    handle->jobs.emplace(id, job);
+  }
 
-    // Format results
-    std::ostringstream oss;
-    if (res.empty()) {
-      oss << "no results";
+  worker_pool().submit([job] {
+    if (job->request.params.cancel.isCancelled()) {
+      job->output.error = "ERROR: cancelled";
     } else {
-      oss << "size: " << res.size() << "\n";
-      for (const Result &r : res) {
-        oss << r.getSequenceString() << " " << std::fixed << std::setprecision(3)
-            << r.keyCost << "\n";
-      }
+      job->output = run_analysis(job->request, job->config, *job->cache);
     }
+    job->done.store(true, std::memory_order_release);
+  });
+  return id;
+}
 
-    if constexpr (DEBUG_ENABLED) {
-      oss << "\n ----------------DEBUG---------------- \n" << consume_debug_output();
+// Returns NULL while the job is still running. Once finished, returns the same
+// results vimficiency_analyze would have and forgets the job.
+// Unknown (or already collected/cancelled) ids report an error.
+const VimficiencyResults *vimficiency_poll(VimficiencyHandle *handle, int job_id) {
+  std::shared_ptr<AnalysisJob> job;
+  {
+    std::lock_guard lock(handle->jobsMutex);
+    auto it = handle->jobs.find(job_id);
+    if (it != handle->jobs.end()) {
+      if (!it->second->done.load(std::memory_order_acquire)) {
+        return nullptr;
+      }
+      job = std::move(it->second);
+      handle->jobs.erase(it);
     }
+  }
 
-    result_storage = oss.str();
-  } catch (const std::exception& e) {
-    result_storage = std::string("ERROR: ") + e.what();
+  if (!job) {
+    AnalysisOutput unknown;
+    unknown.error = "ERROR: unknown job " + std::to_string(job_id);
+    return handle->arena.fill(std::move(unknown));
   }
-  return result_storage.c_str();
+  return handle->arena.fill(std::move(job->output));
+}
+
+// Requests the job stop at its next expansion and forgets it. The worker
+// finishes in the background and its output is discarded.
+void vimficiency_cancel(VimficiencyHandle *handle, int job_id) {
+  std::lock_guard lock(handle->jobsMutex);
+  auto it = handle->jobs.find(job_id);
+  if (it == handle->jobs.end()) {
+    return;
+  }
+  it->second->request.params.cancel.cancel();
+  handle->jobs.erase(it);
+}
+
+VimficiencyCacheStats vimficiency_cache_stats(VimficiencyHandle *handle) {
+  const ResultCache &cache = *handle->cache;
+  return {cache.hits(), cache.misses(), cache.size(), cache.bytes(), cache.maxBytes()};
+}
+
+// Shrinking evicts least recently used entries; 0 disables caching
+void vimficiency_set_cache_capacity(VimficiencyHandle *handle, size_t max_bytes) {
+  handle->cache->setMaxBytes(max_bytes);
 }
 
 const char* vimficiency_get_debug() {
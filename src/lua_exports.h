@@ -0,0 +1,135 @@
+// src/lua_exports.h
+//
+// C API of the shared library. lua/vimficiency/ffi.lua mirrors these
+// declarations in its ffi.cdef, so the two must change together.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Keyboard/KeyboardModel.h"
+
+enum DEFAULT_KEYBOARD {
+  NONE,
+  UNIFORM,
+  QWERTY,
+  COLEMAK_DH,
+};
+
+struct C_ScoreWeights {
+  double w_key = 1.0;
+  double w_same_finger{};
+  double w_same_key{};
+  double w_alt_bonus{};
+  double w_run_pen{};
+  double w_roll_good{};
+  double w_roll_bad{};
+};
+
+struct C_KeyInfo {
+  int8_t hand = static_cast<int8_t>(Hand::None);
+  int8_t finger = static_cast<int8_t>(Finger::None);
+  double base_cost = 0.0;
+};
+
+struct VimficiencyConfigFFI {
+  DEFAULT_KEYBOARD default_keyboard = UNIFORM;
+  C_ScoreWeights weights{};
+  C_KeyInfo keys[KEY_COUNT]{};
+  int slice_buffer_amount{};
+};
+
+// Analysis results, laid out for direct reads from LuaJIT FFI.
+// All pointers point into the owning handle's arena and stay valid until the
+// next analyze/poll call on that handle (or its destruction).
+struct VimficiencySegment {
+  int mode; // Mode enum value (Normal, Insert, Visual)
+  const char *keys;
+  size_t keys_len;
+};
+
+struct VimficiencyResult {
+  const char *seq; // All segments' keys concatenated
+  size_t seq_len;
+  double cost;
+  int end_row;
+  int end_col;
+  const VimficiencySegment *segments;
+  size_t segment_count;
+};
+
+struct VimficiencyStats {
+  int explored;
+  double user_effort;
+  double elapsed_ms;
+  bool cancelled;
+  bool cached; // Served from the handle's result cache
+};
+
+struct VimficiencyResults {
+  const char *error; // NULL on success
+  const VimficiencyResult *results;
+  size_t count;
+  const char *debug;
+  size_t debug_len;
+  VimficiencyStats stats;
+};
+
+struct VimficiencyCacheStats {
+  uint64_t hits;
+  uint64_t misses;
+  size_t entries;
+  size_t bytes;
+  size_t max_bytes;
+};
+
+// Per-caller analysis state: jobs, result arena and result cache
+struct VimficiencyHandle;
+
+extern "C" {
+
+extern const int VIMFICIENCY_KEY_COUNT;
+extern const int VIMFICIENCY_FINGER_COUNT;
+extern const int VIMFICIENCY_HAND_COUNT;
+
+VimficiencyConfigFFI *vimficiency_get_config();
+void vimficiency_apply_config();
+
+const char *vimficiency_key_name(int index);
+const char *vimficiency_hand_name(int index);
+const char *vimficiency_finger_name(int index);
+
+VimficiencyHandle *vimficiency_create();
+void vimficiency_destroy(VimficiencyHandle *handle);
+
+const VimficiencyResults *vimficiency_analyze(
+  VimficiencyHandle *handle,
+  const char *text,
+  bool includes_real_top, bool includes_real_bottom,
+  int start_row, int start_col,
+  int end_row, int end_col,
+  const char *keyseq,
+  int top_row, int bottom_row, int window_height, int scroll_amount,
+  int RESULTS_CALCULATED);
+
+int vimficiency_submit(
+  VimficiencyHandle *handle,
+  const char *text,
+  bool includes_real_top, bool includes_real_bottom,
+  int start_row, int start_col,
+  int end_row, int end_col,
+  const char *keyseq,
+  int top_row, int bottom_row, int window_height, int scroll_amount,
+  int RESULTS_CALCULATED);
+const VimficiencyResults *vimficiency_poll(VimficiencyHandle *handle, int job_id);
+void vimficiency_cancel(VimficiencyHandle *handle, int job_id);
+
+VimficiencyCacheStats vimficiency_cache_stats(VimficiencyHandle *handle);
+void vimficiency_set_cache_capacity(VimficiencyHandle *handle, size_t max_bytes);
+
+const char *vimficiency_get_debug();
+const char *vimficiency_tokenize_motions(const char *seq);
+const char *vimficiency_debug_config();
+
+}
@@ -66,7 +66,7 @@ int main(int argc, char* argv[]) {
   } else {
     cout << "res" << endl;
     for(Result r : res) {
-      cout << r.getSequenceString() << " " << std::format("{:3f}", r.keyCost) << endl;
+      cout << r.getSequenceString() << " " << fixed << setprecision(6) << r.keyCost << endl;
     }
   }
 
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "Editor/LandingIndex.h"
+#include "Editor/Motion.h"
+#include "Editor/NavContext.h"
+
+using namespace std;
+
+namespace {
+
+// Random buffers over characters that matter to word, WORD, sentence and
+// paragraph motions, with empty and blank lines mixed in
+vector<string> randomBuffer(mt19937& rng) {
+  static const string alphabet = "ab_ .!?,;()\"\t-A";
+  int lineCount = 1 + rng() % 8;
+  vector<string> lines;
+  for (int i = 0; i < lineCount; i++) {
+    int kind = rng() % 6;
+    if (kind == 0) {
+      lines.push_back("");
+    } else if (kind == 1) {
+      lines.push_back(string(1 + rng() % 3, ' '));
+    } else {
+      string line;
+      int len = 1 + rng() % 14;
+      for (int c = 0; c < len; c++) {
+        line += alphabet[rng() % alphabet.size()];
+      }
+      lines.push_back(line);
+    }
+  }
+  return lines;
+}
+
+} // namespace
+
+TEST(LandingIndexTest, CountedMotionsMatchStepLoop) {
+  const vector<string> motions = {"w", "b", "e", "ge", "W", "B", "E", "gE", "}", "{", ")", "("};
+  NavContext navContext(20, 10);
+  mt19937 rng(12345);
+
+  int checked = 0;
+  for (int iter = 0; iter < 150; iter++) {
+    vector<string> lines = randomBuffer(rng);
+    LandingIndex landings(lines);
+
+    for (int line = 0; line < static_cast<int>(lines.size()); line++) {
+      int cols = max(1, static_cast<int>(lines[line].size()));
+      for (int col = 0; col < cols; col++) {
+        for (const string& motion : motions) {
+          for (int count : {1, 2, 3, 5, 9, 40}) {
+            Position looped(line, col);
+            Position indexed(line, col);
+            Mode mode = Mode::Normal;
+            ParsedMotion parsed(motion, count);
+            applyParsedMotion(looped, mode, navContext, parsed, lines);
+            applyParsedMotion(indexed, mode, navContext, parsed, lines, &landings);
+            ASSERT_EQ(indexed, looped)
+              << count << motion << " from (" << line << ", " << col << ") in buffer #" << iter;
+            checked++;
+          }
+        }
+      }
+    }
+  }
+  EXPECT_GT(checked, 10000);
+}
+
+TEST(LandingIndexTest, AdvanceFollowsChain) {
+  vector<string> lines = {"one two three", "", "four five", "", "six"};
+  LandingIndex landings(lines);
+
+  // w stops on the following word starts, in order
+  EXPECT_EQ(landings.advance(CountedMotion::WordNext, Position(0, 0), 1), Position(0, 4));
+  EXPECT_EQ(landings.advance(CountedMotion::WordNext, Position(0, 1), 2), Position(0, 8));
+  EXPECT_EQ(landings.advance(CountedMotion::WordPrev, Position(2, 6), 2), Position(2, 0));
+
+  // Counts past the last landing stay there, like the loop
+  Position looped(0, 0);
+  for (int i = 0; i < 100; i++) LandingIndex::step(CountedMotion::WordEndNext, looped, lines);
+  EXPECT_EQ(landings.advance(CountedMotion::WordEndNext, Position(0, 0), 100), looped);
+
+  // Motions that need their loop are never answered
+  EXPECT_FALSE(LandingIndex::indexed(CountedMotion::ParagraphPrev));
+  EXPECT_FALSE(landings.advance(CountedMotion::ParagraphPrev, Position(4, 0), 2).has_value());
+}
+
+TEST(LandingIndexTest, AdvanceAnswersIndexedCounts) {
+  vector<string> lines = {"alpha beta. Gamma delta.", "", "epsilon zeta eta", "", "theta."};
+  LandingIndex landings(lines);
+  NavContext navContext(20, 10);
+
+  struct Case { const char* seq; CountedMotion motion; int count; Position from; };
+  for (const Case& c : {Case{"3w", CountedMotion::WordNext, 3, Position(0, 0)},
+                        Case{"5b", CountedMotion::WordPrev, 5, Position(2, 13)},
+                        Case{"4e", CountedMotion::WordEndNext, 4, Position(0, 0)},
+                        Case{"2ge", CountedMotion::WordEndPrev, 2, Position(2, 8)},
+                        Case{"2W", CountedMotion::BigWordNext, 2, Position(0, 0)},
+                        Case{"3B", CountedMotion::BigWordPrev, 3, Position(4, 0)},
+                        Case{"1000w", CountedMotion::WordNext, 1000, Position(0, 0)},
+                        Case{"10gE", CountedMotion::BigWordEndPrev, 10, Position(4, 3)}}) {
+    // The index answers these itself rather than leaving them to the loop
+    optional<Position> advanced = landings.advance(c.motion, c.from, c.count);
+    ASSERT_TRUE(advanced.has_value()) << c.seq;
+    Position stepped = c.from;
+    for (int i = 0; i < c.count; i++) LandingIndex::step(c.motion, stepped, lines);
+    EXPECT_EQ(*advanced, stepped) << c.seq;
+
+    MotionResult looped = simulateMotions(c.from, Mode::Normal, navContext, c.seq, lines);
+    MotionResult indexed = simulateMotions(c.from, Mode::Normal, navContext, c.seq, lines, &landings);
+    EXPECT_EQ(indexed.pos, looped.pos) << c.seq;
+  }
+}
@@ -174,6 +174,21 @@ TEST(DiffStateTest, Accessors) {
   EXPECT_EQ(diffs[0].newCharCount(), 3);
 }
 
+TEST(DiffStateTest, Accessors_LineOffsets) {
+  DiffState diff({1, 2}, {3, 1}, "ab\n\nxy", "p\nqrs");
+
+  EXPECT_EQ(diff.deletedLines(), Lines({"ab", "", "xy"}));
+  EXPECT_EQ(diff.origLineCount(), 3);
+  EXPECT_EQ(diff.deletedLineOffsets(), std::vector<int>({0, 2, 2, 4}));
+  EXPECT_EQ(diff.newLineCount(), 2);
+  EXPECT_EQ(diff.insertedLineOffsets(), std::vector<int>({0, 1, 4}));
+
+  // Default constructed: one empty line on each side, like unflatten("")
+  DiffState empty;
+  EXPECT_EQ(empty.deletedLines(), Lines({""}));
+  EXPECT_EQ(empty.insertedLineOffsets(), std::vector<int>({0, 0}));
+}
+
 // =============================================================================
 // Edge Cases
 // =============================================================================
@@ -286,3 +301,74 @@ TEST(DiffStateTest, SimpleJoin) {
   printDiffs("SimpleJoin", diffs);
   expectRoundTrip(start, end);
 }
+
+// =============================================================================
+// Large Inputs
+// =============================================================================
+
+TEST(DiffStateTest, Greedy_KeepsEarliestMatch) {
+  // The forward search matches the first 'a', so the second one is deleted
+  auto diffs = Myers::calculate({"aab"}, {"ab"});
+  expectDiffs(diffs, {{"a", ""}});
+  EXPECT_EQ(diffs[0].posBegin.col, 1);
+}
+
+TEST(DiffStateTest, LargeBuffer_ScatteredEdits) {
+  // 10k lines with a few hundred scattered one-line changes; the edit
+  // distance is large enough to exercise the divide and conquer traceback
+  Lines start;
+  Lines end;
+  unsigned seed = 12345;
+  auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0x7fff; };
+  for (int i = 0; i < 10000; i++) {
+    std::string line = "  value_" + std::to_string(i) + " = compute(" + std::to_string(next() % 1000) + ");";
+    start.push_back(line);
+    if (i % 37 == 5) {
+      line.replace(2, 5, "result");
+    } else if (i % 53 == 7) {
+      line += " // changed";
+    }
+    end.push_back(line);
+  }
+
+  auto diffs = Myers::calculate(start, end);
+  EXPECT_GE(diffs.size(), 300u);
+  expectRoundTrip(start, end);
+}
+
+TEST(DiffStateTest, Anchored_SwappedLines) {
+  // Unique lines anchor the line-level pass, so the moved line is one
+  // deletion plus one insertion rather than a character-level interleaving
+  Lines start = {"int first = load();", "int second = store();"};
+  Lines end = {"int second = store();", "int first = load();"};
+  auto diffs = Myers::calculate(start, end);
+  printDiffs("SwappedLines", diffs);
+  expectDiffs(diffs, {{"int first = load();\n", ""}, {"", "\nint first = load();"}});
+  expectRoundTrip(start, end);
+}
+
+TEST(DiffStateTest, Anchored_PositionsAfterUnchangedLines) {
+  Lines start = {"alpha", "beta", "gamma", "delta", "epsilon"};
+  Lines end = {"alpha", "beta", "gamma", "DELTA", "epsilon"};
+  auto diffs = Myers::calculate(start, end);
+  expectDiffs(diffs, {{"delta", "DELTA"}});
+  EXPECT_EQ(diffs[0].posBegin, Position(3, 0));
+  EXPECT_EQ(diffs[0].posEnd, Position(3, 4));
+}
+
+TEST(DiffStateTest, LongLine_ChangeAtEveryOffset) {
+  // Snakes compare many bytes per step; a change at any offset of a long
+  // line must still be found exactly
+  std::string base;
+  for (int i = 0; i < 80; i++) {
+    base += static_cast<char>('a' + (i * 7) % 26);
+  }
+  for (int at = 0; at < static_cast<int>(base.size()); at++) {
+    std::string changed = base;
+    changed[at] = '#';
+    auto diffs = Myers::calculate({base}, {changed});
+    ASSERT_EQ(diffs.size(), 1u) << "offset " << at;
+    EXPECT_EQ(diffs[0].posBegin, Position(0, at));
+    EXPECT_EQ(Myers::applyAllDiffState(diffs, {base}), Lines{changed});
+  }
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <random>
+
 #include "Utils/Lines.h"
 #include "Optimizer/Levenshtein.h"
 
@@ -173,3 +176,122 @@ TEST(LevenshteinTest, SymmetryProperty) {
 
   EXPECT_EQ(lev1.distance("world"), lev2.distance("hello"));
 }
+
+// -----------------------------------------------------------------------------
+// Bit-parallel kernel vs. reference DP
+// -----------------------------------------------------------------------------
+
+static int referenceDistance(const std::string& a, const std::string& b) {
+  std::vector<int> prev(b.size() + 1), curr(b.size() + 1);
+  for (size_t j = 0; j <= b.size(); ++j) prev[j] = static_cast<int>(j);
+  for (size_t i = 1; i <= a.size(); ++i) {
+    curr[0] = static_cast<int>(i);
+    for (size_t j = 1; j <= b.size(); ++j) {
+      curr[j] = std::min({prev[j] + 1, curr[j - 1] + 1,
+                          prev[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1)});
+    }
+    std::swap(prev, curr);
+  }
+  return prev[b.size()];
+}
+
+TEST(LevenshteinTest, BitParallelMatchesReferenceAcrossBlockSizes) {
+  std::mt19937 rng(1234);
+  // Small alphabet so matches are common; lengths straddle the 64-bit block edges
+  auto randomString = [&rng](size_t len) {
+    std::string s(len, 'a');
+    for (char& c : s) c = "ab \n"[rng() % 4];
+    return s;
+  };
+  for (size_t goalLen : {1, 7, 63, 64, 65, 127, 128, 129, 200}) {
+    for (int trial = 0; trial < 20; ++trial) {
+      std::string goal = randomString(goalLen);
+      std::string source = randomString(rng() % 220 + 1);
+      Levenshtein lev(goal);
+      EXPECT_EQ(lev.distance(source), referenceDistance(source, goal))
+          << "goal length " << goalLen << ", source length " << source.size();
+    }
+  }
+}
+
+TEST(LevenshteinTest, FractionalDeletionCostUsesDP) {
+  Levenshtein lev("ab", 0.5);
+  // Delete "xyz" at 0.5 each
+  EXPECT_DOUBLE_EQ(lev.distanceDouble("abxyz"), 1.5);
+}
+
+// -----------------------------------------------------------------------------
+// Bounded distance
+// -----------------------------------------------------------------------------
+
+TEST(LevenshteinTest, BoundedReportsExceedingBound) {
+  Levenshtein lev("hello world");
+  EXPECT_EQ(lev.distanceBounded("hello earth", 4.0), std::optional<double>(4.0));
+  EXPECT_EQ(lev.distanceBounded("hello earth", 3.0), std::nullopt);
+  // Length gap alone (6 insertions) rules this out
+  EXPECT_EQ(lev.distanceBounded("hello", 5.0), std::nullopt);
+  EXPECT_EQ(lev.distanceBounded("hello", 6.0), std::optional<double>(6.0));
+  EXPECT_EQ(lev.distanceBounded("hello world", 0.0), std::optional<double>(0.0));
+}
+
+TEST(LevenshteinTest, BoundedMatchesFullDistance) {
+  std::mt19937 rng(99);
+  auto randomString = [&rng](size_t len) {
+    std::string s(len, 'a');
+    for (char& c : s) c = "abc "[rng() % 4];
+    return s;
+  };
+  for (double deletionCost : {1.0, 0.5, 0.1}) {
+    for (int trial = 0; trial < 200; ++trial) {
+      std::string goal = randomString(rng() % 40);
+      std::string source = randomString(rng() % 40);
+      Levenshtein lev(goal, deletionCost);
+      double full = lev.distanceDouble(source);
+      double bound = static_cast<double>(rng() % 30);
+      std::optional<double> bounded = lev.distanceBounded(source, bound);
+      if (full <= bound) {
+        ASSERT_TRUE(bounded.has_value()) << source << " -> " << goal << " bound " << bound;
+        EXPECT_NEAR(*bounded, full, 1e-9) << source << " -> " << goal;
+      } else {
+        EXPECT_FALSE(bounded.has_value()) << source << " -> " << goal << " bound " << bound;
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Prefix row cache
+// -----------------------------------------------------------------------------
+
+TEST(LevenshteinTest, PrefixCacheFindsDeepestCachedPrefix) {
+  PrefixRowCache cache(2);
+  const double row[2] = {1.0, 2.0};
+  PrefixRowCache::Node node = PrefixRowCache::ROOT;
+  for (char c : std::string("abcd")) {
+    node = cache.extend(node, c);
+    if (c == 'b') cache.store(node, row);
+  }
+
+  PrefixRowCache::Hit hit = cache.deepest("abcz");
+  EXPECT_EQ(hit.length, 2u);
+  ASSERT_NE(hit.row, nullptr);
+  EXPECT_EQ(hit.row[1], 2.0);
+  EXPECT_EQ(cache.deepest("xyz").row, nullptr);
+}
+
+TEST(LevenshteinTest, PrefixCacheStaysWithinMemoryBound) {
+  // Fractional deletion cost takes the cached DP path
+  Levenshtein lev("the quick brown fox", 0.5);
+  lev.setCacheMaxBytes(4096);
+  Levenshtein reference("the quick brown fox", 0.5);
+
+  std::mt19937 rng(7);
+  for (int q = 0; q < 300; ++q) {
+    std::string source(rng() % 30 + 1, 'a');
+    for (char& c : source) c = "the quick"[rng() % 9];
+    reference.clearCache();
+    EXPECT_DOUBLE_EQ(lev.distanceDouble(source), reference.distanceDouble(source)) << source;
+    EXPECT_LE(lev.cacheBytes(), 4096u);
+  }
+  EXPECT_GT(lev.cachedRows(), 0u);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "Utils/TestUtils.h"
+#include "lua_exports.h"
+
+using namespace std;
+
+namespace {
+
+const char* TEXT = "one two three four\nfive six seven";
+
+int submit(VimficiencyHandle* handle) {
+  return vimficiency_submit(handle, TEXT, true, true, 0, 0, 1, 5, "jwl", 0, 1, 20, 10, 5);
+}
+
+// Polls until the job is collected, or gives up after a few seconds
+const VimficiencyResults* waitFor(VimficiencyHandle* handle, int id) {
+  auto deadline = chrono::steady_clock::now() + chrono::seconds(30);
+  while (chrono::steady_clock::now() < deadline) {
+    if (const VimficiencyResults* out = vimficiency_poll(handle, id)) {
+      return out;
+    }
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  return nullptr;
+}
+
+bool reportsUnknownJob(const VimficiencyResults* out) {
+  return out && out->error && string(out->error).find("unknown job") != string::npos;
+}
+
+} // namespace
+
+TEST(AnalysisJobTest, PolledResultsMatchAnalyze) {
+  VimficiencyHandle* direct = vimficiency_create();
+  const VimficiencyResults* analyzed =
+      vimficiency_analyze(direct, TEXT, true, true, 0, 0, 1, 5, "jwl", 0, 1, 20, 10, 5);
+  ASSERT_EQ(analyzed->error, nullptr);
+  ASSERT_GT(analyzed->count, 0u);
+  vector<AnalyzedResult> expected = copyResults(analyzed);
+  vimficiency_destroy(direct);
+
+  // A separate handle, so the job searches rather than hitting the cache
+  VimficiencyHandle* handle = vimficiency_create();
+  int id = submit(handle);
+  ASSERT_GT(id, 0);
+  const VimficiencyResults* polled = waitFor(handle, id);
+  ASSERT_NE(polled, nullptr) << "job never finished";
+  ASSERT_EQ(polled->error, nullptr);
+  EXPECT_FALSE(polled->stats.cancelled);
+  EXPECT_EQ(copyResults(polled), expected);
+
+  // Collected jobs are forgotten
+  EXPECT_TRUE(reportsUnknownJob(vimficiency_poll(handle, id)));
+  vimficiency_destroy(handle);
+}
+
+TEST(AnalysisJobTest, CancelledJobIsForgotten) {
+  VimficiencyHandle* handle = vimficiency_create();
+  int id = submit(handle);
+  vimficiency_cancel(handle, id);
+  EXPECT_TRUE(reportsUnknownJob(vimficiency_poll(handle, id)));
+
+  // Ids aren't reused, and the handle keeps working
+  int next = submit(handle);
+  EXPECT_NE(next, id);
+  const VimficiencyResults* out = waitFor(handle, next);
+  ASSERT_NE(out, nullptr) << "job never finished";
+  EXPECT_EQ(out->error, nullptr);
+  vimficiency_destroy(handle);
+}
+
+TEST(AnalysisJobTest, DestroyWithPendingJob) {
+  // The job owns its inputs and cache, so it can outlive the handle
+  VimficiencyHandle* handle = vimficiency_create();
+  for (int i = 0; i < 4; i++) submit(handle);
+  vimficiency_destroy(handle);
+
+  // Later handles still get results from the same worker pool
+  VimficiencyHandle* next = vimficiency_create();
+  const VimficiencyResults* out = waitFor(next, submit(next));
+  ASSERT_NE(out, nullptr) << "job never finished";
+  EXPECT_EQ(out->error, nullptr);
+  EXPECT_GT(out->count, 0u);
+  vimficiency_destroy(next);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <stdexcept>
 
+#include "Editor/Edit.h"
 #include "Editor/Motion.h"
 #include "Keyboard/SequenceTokenizer.h"
 #include "Keyboard/MotionToKeys.h"
@@ -58,3 +59,69 @@ TEST(ErrorHandlingTest, TokenizerAcceptsValidSequences) {
   EXPECT_NO_THROW(tokenizer.tokenize("123"));
   EXPECT_NO_THROW(tokenizer.tokenize("wWbBeE"));
 }
+
+// tryApplyEdit must agree with applyEdit everywhere: Ok exactly when applyEdit
+// succeeds, with the same result, and no changes at all otherwise.
+TEST(ErrorHandlingTest, TryApplyEditMatchesApplyEdit) {
+  const vector<Lines> buffers = {
+    {"foo bar", "", "  baz"},
+    {"x"},
+    {""},
+    {},
+  };
+  const vector<string> edits = {
+    "x", "X", "s", "~", "ra", "J", "gJ", "dd", "cc", "S", "D", "d$", "C", "c$",
+    "dw", "dW", "de", "dE", "db", "dB", "dge", "dgE", "cw", "ce", "cb", "cge",
+    "d0", "d^", "c0", "c^", "diw", "daw", "ciW", "caW", "dq",
+    "i", "a", "I", "A", "o", "O", "j", "k", "h", "l", "w", "b", "0", "^", "$",
+    "<Esc>", "<BS>", "<Del>", "<CR>", "<C-u>", "<C-w>", "<Left>", "<Right>", "<Up>", "<Down>",
+  };
+  NavContext ctx(20, 10);
+
+  for (const Lines& buffer : buffers) {
+    vector<Position> positions = {Position(0, 0)};
+    for (int r = 0; r < static_cast<int>(buffer.size()); r++) {
+      for (int c = 0; c <= static_cast<int>(buffer[r].size()); c++) {
+        positions.push_back(Position(r, c));
+      }
+    }
+    for (const Position& start : positions) {
+      for (Mode startMode : {Mode::Normal, Mode::Insert}) {
+        // Normal mode cursor can't sit past the last char
+        if (startMode == Mode::Normal && !buffer.empty()
+            && start.col > 0 && start.col >= static_cast<int>(buffer[start.line].size())) {
+          continue;
+        }
+        for (const string& e : edits) {
+          Lines expectedLines = buffer;
+          Position expectedPos = start;
+          Mode expectedMode = startMode;
+          bool threw = false;
+          try {
+            Edit::applyEdit(expectedLines, expectedPos, expectedMode, ctx, ParsedEdit(e));
+          } catch (const runtime_error&) {
+            threw = true;
+          }
+
+          Lines lines = buffer;
+          Position pos = start;
+          Mode mode = startMode;
+          EditStatus status = Edit::tryApplyEdit(lines, pos, mode, ctx, ParsedEdit(e));
+          string where = e + " at " + to_string(start.line) + "," + to_string(start.col)
+                       + (startMode == Mode::Insert ? " (insert)" : "");
+
+          EXPECT_EQ(status == EditStatus::Ok, !threw) << where;
+          if (threw) {
+            EXPECT_EQ(lines, buffer) << where;
+            EXPECT_EQ(pos, start) << where;
+            EXPECT_EQ(mode, startMode) << where;
+          } else {
+            EXPECT_EQ(lines, expectedLines) << where;
+            EXPECT_EQ(pos, expectedPos) << where;
+            EXPECT_EQ(mode, expectedMode) << where;
+          }
+        }
+      }
+    }
+  }
+}
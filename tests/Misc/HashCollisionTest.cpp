@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <string_view>
 
+#include "Utils/BufferFingerprint.h"
+
 // Must match the hash function in Edit.cpp
 constexpr size_t HASH_MULTIPLIER = 131;
 
@@ -35,3 +37,31 @@ TEST(HashCollisionTest, HashMatchesBaseConversion) {
 TEST(HashCollisionTest, EmptyStringHashIsZero) {
   EXPECT_EQ(editHash(""), 0);
 }
+
+TEST(HashCollisionTest, FingerprintIsOrderSensitive) {
+  Lines ab = {"a", "b"};
+  Lines ba = {"b", "a"};
+  Lines joined = {"ab"};
+  EXPECT_NE(BufferFingerprint(ab).value(), BufferFingerprint(ba).value());
+  EXPECT_NE(BufferFingerprint(ab).value(), BufferFingerprint(joined).value());
+  EXPECT_NE(BufferFingerprint(Lines{}).value(), BufferFingerprint(Lines{""}).value());
+}
+
+TEST(HashCollisionTest, FingerprintUpdateMatchesRecompute) {
+  Lines before = {"one", "two", "three", "four"};
+  BufferFingerprint fp(before);
+
+  for (Lines after : {Lines{"one", "tw", "three", "four"},
+                      Lines{"one", "three", "four"},
+                      Lines{"one", "two", "", "three", "four"},
+                      Lines{"four"},
+                      Lines{"zero", "one", "two", "three", "four"},
+                      Lines{"one", "two", "three", "four", "five", "six"},
+                      Lines{"one", "two", "three"},
+                      Lines{"one", "2", "3", "4", "5", "three", "four"},
+                      Lines{""},
+                      Lines{"one", "two", "three", "four"}}) {
+    EXPECT_EQ(fp.updated(before, after).value(), BufferFingerprint(after).value())
+        << after.flatten();
+  }
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "Keyboard/MotionToKeys.h"
+#include "Optimizer/Config.h"
+#include "State/RunningEffort.h"
+
+using namespace std;
+
+TEST(RunningEffortTest, TypingContextDeterminesEffortGrowth) {
+  // Different histories ending in the same key and hand run grow equally
+  Config config = Config::qwerty();
+  const SequenceTokenizer& tokenizer = globalTokenizer();
+  RunningEffort a;
+  RunningEffort b;
+  a.append(tokenizer.tokenize("lj"), config);
+  b.append(tokenizer.tokenize("sdlj"), config);
+  ASSERT_EQ(a.typingContext(), b.typingContext());
+
+  double beforeA = a.getEffort(config);
+  double beforeB = b.getEffort(config);
+  PhysicalKeys next = tokenizer.tokenize("wbj");
+  EXPECT_DOUBLE_EQ(a.append(next, config) - beforeA, b.append(next, config) - beforeB);
+
+  RunningEffort c;
+  c.append(tokenizer.tokenize("w"), config);
+  EXPECT_NE(a.typingContext(), c.typingContext());
+}
+
+TEST(RunningEffortTest, AppendKnownMatchesReplay) {
+  // Appending a segment with its standalone effort re-scores only the seam
+  Config config = Config::qwerty();
+  const SequenceTokenizer& tokenizer = globalTokenizer();
+  for (const char* prefix : {"", "j", "sdf", "jkl", "dw"}) {
+    for (const char* segment : {"x", "ciwfoo<Esc>", "kkkkdd", "asdfgq", "lhlh"}) {
+      PhysicalKeys keys = tokenizer.tokenize(segment);
+      RunningEffort standalone;
+      standalone.append(keys, config);
+
+      RunningEffort replayed;
+      RunningEffort known;
+      replayed.append(tokenizer.tokenize(prefix), config);
+      known.append(tokenizer.tokenize(prefix), config);
+      EXPECT_NEAR(known.appendKnown(keys, standalone, config),
+                  replayed.append(keys, config), 1e-9) << prefix << " + " << segment;
+      EXPECT_EQ(known.typingContext(), replayed.typingContext());
+
+      // Later keys see the same memory
+      PhysicalKeys next = tokenizer.tokenize("jj");
+      EXPECT_NEAR(known.append(next, config), replayed.append(next, config), 1e-9);
+    }
+  }
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <tuple>
+
+#include "Editor/NavContext.h"
+#include "Optimizer/CompositionOptimizer.h"
+#include "Optimizer/Config.h"
+#include "Optimizer/OptimizerParams.h"
+#include "Utils/Lines.h"
+
+using namespace std;
+
+class CompositionSearchTest : public ::testing::Test {
+protected:
+  Config config = Config::uniform();
+  NavContext navContext{20, 10};
+
+  vector<Result> run(const Lines& start, Position startPos, const Lines& end,
+                     const string& userSequence, int searchThreads) {
+    CompositionOptimizer optimizer(config);
+    OptimizerParams params(5);
+    params.searchThreads = searchThreads;
+    return optimizer.optimize(start, startPos, end, Position(0, 0), userSequence,
+                              navContext, ImpliedExclusions(), EXPLORABLE_MOTIONS, params);
+  }
+};
+
+TEST_F(CompositionSearchTest, DistributedMatchesSequentialResults) {
+  for (auto [start, end, userSequence] : vector<tuple<Lines, Lines, string>>{
+         {{"foo(1); foo(2);", "foo(3);"}, {"bar(1); foo(2);", "foo(3);"}, "ciwbar<Esc>"},
+         {{"alpha beta", "gamma delta"}, {"alpha BETA", "gamma DELTA"}, "wcwBETA<Esc>jbcwDELTA<Esc>"},
+         {{"x = foo(y)", "z", "x = foo(y)"}, {"x = bar(y)", "z", "x = bar(y)"},
+          "wwcwbar<Esc>jjbbcwbar<Esc>"},
+         {{"foo bar baz", "qux"}, {"FOO bar BAZ", "qux"}, "cwFOO<Esc>wwcwBAZ<Esc>"},
+         {{"int a = 1;", "int b = 2;", "int c = 3;"}, {"long a = 1;", "int b = 2;", "long c = 3;"},
+          "cwlong<Esc>jjbcwlong<Esc>"},
+         {{"one two", "three four", "five six"}, {"one 2", "three four", "5 six"},
+          "wcw2<Esc>jj0cw5<Esc>"},
+       }) {
+    vector<Result> sequential = run(start, Position(0, 0), end, userSequence, 1);
+    ASSERT_FALSE(sequential.empty()) << userSequence;
+
+    multiset<string> expected;
+    for (const Result& r : sequential) expected.insert(r.getSequenceString());
+
+    for (int threads : {2, 3, 4}) {
+      vector<Result> distributed = run(start, Position(0, 0), end, userSequence, threads);
+      ASSERT_EQ(distributed.size(), sequential.size()) << userSequence << ", " << threads << " threads";
+      multiset<string> actual;
+      for (size_t i = 0; i < distributed.size(); i++) {
+        EXPECT_NEAR(distributed[i].keyCost, sequential[i].keyCost, 1e-6)
+            << userSequence << ", " << threads << " threads, result " << i;
+        actual.insert(distributed[i].getSequenceString());
+      }
+      EXPECT_EQ(actual, expected) << userSequence << ", " << threads << " threads";
+    }
+  }
+}
+
+TEST_F(CompositionSearchTest, DistributedStopsWhenCancelled) {
+  Lines start = {"alpha beta", "gamma delta"};
+  Lines end = {"alpha BETA", "gamma DELTA"};
+
+  CompositionOptimizer optimizer(config);
+  OptimizerParams params(5);
+  params.searchThreads = 4;
+  params.cancel = CancellationToken::create();
+  params.cancel.cancel();
+  vector<Result> results = optimizer.optimize(start, Position(0, 0), end, Position(0, 0),
+                                              "wcwBETA<Esc>jbcwDELTA<Esc>", navContext,
+                                              ImpliedExclusions(), EXPLORABLE_MOTIONS, params);
+  EXPECT_TRUE(results.empty());
+}
+
+TEST_F(CompositionSearchTest, MemoizedSubSearchesMatchFresh) {
+  // Both searches reach the last region from one position along paths of equal
+  // cost, so the memo answers the second movement sub-search
+  for (auto [start, end, userSequence] : vector<tuple<Lines, Lines, string>>{
+         {{"x = foo(y)", "z", "x = foo(y)"}, {"x = bar(y)", "z", "x = bar(y)"},
+          "wwcwbar<Esc>jjbbcwbar<Esc>"},
+         {{"foo bar baz", "qux"}, {"FOO bar BAZ", "qux"}, "cwFOO<Esc>wwcwBAZ<Esc>"},
+       }) {
+    CompositionOptimizer memoized(config);
+    CompositionOptimizer fresh(config);
+    fresh.memoizeSubSearches = false;
+    OptimizerParams params(5);
+    vector<Result> expected = fresh.optimize(start, Position(0, 0), end, Position(0, 0), userSequence,
+                                             navContext, ImpliedExclusions(), EXPLORABLE_MOTIONS, params);
+    vector<Result> actual = memoized.optimize(start, Position(0, 0), end, Position(0, 0), userSequence,
+                                              navContext, ImpliedExclusions(), EXPLORABLE_MOTIONS, params);
+
+    ASSERT_FALSE(expected.empty()) << userSequence;
+    ASSERT_EQ(actual.size(), expected.size()) << userSequence;
+    for (size_t i = 0; i < expected.size(); i++) {
+      EXPECT_EQ(actual[i].getSequenceString(), expected[i].getSequenceString()) << userSequence;
+      EXPECT_DOUBLE_EQ(actual[i].keyCost, expected[i].keyCost) << userSequence;
+    }
+  }
+}
@@ -334,6 +334,37 @@ TEST_F(EditOptimizerTest, DeletionSearch_MixedLengths) {
 // Boundary-constrained deletion tests
 // =============================================================================
 
+TEST_F(EditOptimizerTest, DeletionSearch_LongLinesSolveEveryStart) {
+  // Many starts on long lines: each one must still get a verified solution
+  Lines source = {"the quick brown fox", "jumps over"};
+
+  EditBoundary boundary;
+  boundary.hasLinesBelow = true;
+
+  EditOptimizer opt = makeOptimizer();
+  DeletionResult res = opt.optimizeDeletion(source, boundary);
+
+  consume_debug_output();
+
+  int verified = 0;
+  for (int r = 0; r < res.rows; r++) {
+    for (int c = 0; c < (int)source[r].size(); c++) {
+      const Result& result = res.at(r, c);
+      ASSERT_TRUE(result.isValid()) << "No solution for [" << r << "," << c << "]";
+
+      ApplyResult applied = applySequence(source, Position(r, c), result.getSequenceString());
+      EXPECT_TRUE(isValidDeletionGoal(applied))
+          << "Sequence '" << result.getSequenceString() << "' from [" << r << "," << c << "] "
+          << "did not reach goal. Lines: " << applied.lines;
+      verified++;
+    }
+  }
+  EXPECT_EQ(verified, 29);
+
+  // Starting on the first line, deleting it and substituting the rest is hard to beat
+  EXPECT_LE(res.at(0, 10).keyCost, 3.0);
+}
+
 TEST_F(EditOptimizerTest, DeletionSearch_WithLinesBelow) {
   // When hasLinesBelow=true, dd on last line is invalid (cursor would escape)
   // Simulates edit region embedded in larger buffer:
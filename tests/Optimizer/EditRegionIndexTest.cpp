@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "Optimizer/DiffState.h"
+#include "Optimizer/EditRegionIndex.h"
+
+using namespace std;
+
+TEST(EditRegionIndexTest, SingleLineRegion) {
+  EditRegionIndex index({DiffState({0, 4}, {0, 6}, "bbb", "ccc")});
+
+  EXPECT_TRUE(index.regionsAt({0, 3}).empty());
+  EXPECT_EQ(index.regionsAt({0, 4}), vector<int>({0}));
+  EXPECT_EQ(index.regionsAt({0, 6}), vector<int>({0}));
+  EXPECT_TRUE(index.regionsAt({0, 7}).empty());
+  EXPECT_TRUE(index.regionsAt({1, 5}).empty());
+}
+
+TEST(EditRegionIndexTest, MultiLineRegionCoversWholeMiddleLines) {
+  // Lines longer than any fixed key width are fine
+  EditRegionIndex index({DiffState({2, 150}, {4, 3}, string(60, 'x') + "\n" + string(500, 'y') + "\n" + "zzzz", "")});
+
+  EXPECT_FALSE(index.contains({2, 149}, 0));
+  EXPECT_TRUE(index.contains({2, 150}, 0));
+  EXPECT_TRUE(index.contains({2, 209}, 0));
+  EXPECT_TRUE(index.contains({3, 0}, 0));
+  EXPECT_TRUE(index.contains({3, 499}, 0));
+  EXPECT_TRUE(index.contains({4, 3}, 0));
+  EXPECT_FALSE(index.contains({4, 4}, 0));
+}
+
+TEST(EditRegionIndexTest, PureInsertionCoversOnlyItsPoint) {
+  EditRegionIndex index({DiffState({1, 2}, {1, 2}, "", "inserted")});
+
+  EXPECT_TRUE(index.contains({1, 2}, 0));
+  EXPECT_FALSE(index.contains({1, 3}, 0));
+  EXPECT_FALSE(index.contains({1, 2}, 1));
+}
+
+TEST(EditRegionIndexTest, OverlappingRegions) {
+  // Sequential diffs can overlap once earlier edits shift the buffer
+  EditRegionIndex index({
+      DiffState({0, 0}, {3, 0}, "a\nb\nc\nd", ""),
+      DiffState({1, 5}, {1, 8}, "wxyz", "q"),
+      DiffState({1, 7}, {1, 7}, "", "r"),
+      DiffState({5, 0}, {5, 1}, "ef", "g"),
+  });
+
+  EXPECT_EQ(index.regionsAt({1, 7}), vector<int>({0, 1, 2}));
+  EXPECT_EQ(index.regionsAt({1, 9}), vector<int>({0}));
+  EXPECT_EQ(index.regionsAt({3, 1}), vector<int>());
+  EXPECT_EQ(index.regionsAt({5, 1}), vector<int>({3}));
+}
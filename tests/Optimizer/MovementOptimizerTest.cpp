@@ -199,3 +199,62 @@ TEST_F(MovementOptimizerTest, RangeWithWordMotions) {
 
   EXPECT_FALSE(results.empty()) << "Should find paths using word motions";
 }
+
+TEST_F(MovementOptimizerTest, RangeResultsIgnorePriorEffort) {
+  // Sub-searches are shared between states with equal typing context, so the
+  // effort typed before them must not change which paths they keep
+  Lines lines = {"one two three four five six", "seven eight nine"};
+  Config config = Config::uniform();
+  MovementOptimizer opt(config);
+  ImpliedExclusions impliedExclusions(false, false);
+  OptimizerParams params(10, 2e4, 1.0, 2.0);
+
+  const SequenceTokenizer& tokenizer = globalTokenizer();
+  RunningEffort fresh;
+  RunningEffort typed;
+  fresh.append(tokenizer.tokenize("lj"), config);
+  typed.append(tokenizer.tokenize("sdfsdfsdfsdfsdfsdfsdfsdflj"), config);
+  ASSERT_EQ(fresh.typingContext(), typed.typingContext());
+  // More than the whole budget was spent before the sub-search started
+  ASSERT_GT(typed.getEffort(config), getEffort("wwww", config) * params.exploreFactor);
+
+  vector<RangeResult> expected = opt.optimizeToRange(lines, Position(0, 0), fresh, Position(0, 14),
+                                                     Position(0, 22), "wwww", navContext, false,
+                                                     impliedExclusions, EXPLORABLE_MOTIONS, params);
+  vector<RangeResult> actual = opt.optimizeToRange(lines, Position(0, 0), typed, Position(0, 14),
+                                                   Position(0, 22), "wwww", navContext, false,
+                                                   impliedExclusions, EXPLORABLE_MOTIONS, params);
+  ASSERT_FALSE(expected.empty());
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(actual[i].getSequenceString(), expected[i].getSequenceString());
+    EXPECT_EQ(actual[i].endPos, expected[i].endPos);
+  }
+}
+
+TEST_F(MovementOptimizerTest, CancelledSearchStopsEarly) {
+  Lines lines = {"one two three four five six"};
+  MovementOptimizer opt(Config::uniform());
+  ImpliedExclusions impliedExclusions(false, false);
+
+  OptimizerParams params(30, 2e4, 1.0, 2.0);
+  params.cancel = CancellationToken::create();
+
+  vector<Result> before = opt.optimize(lines, Position(0, 0), RunningEffort(), Position(0, 14),
+                                       "wwf", navContext, impliedExclusions, EXPLORABLE_MOTIONS, params);
+  EXPECT_FALSE(before.empty());
+
+  // Copies share the flag, so cancelling the original stops searches using the copy
+  CancellationToken copy = params.cancel;
+  copy.cancel();
+  EXPECT_TRUE(params.cancel.isCancelled());
+
+  vector<Result> after = opt.optimize(lines, Position(0, 0), RunningEffort(), Position(0, 14),
+                                      "wwf", navContext, impliedExclusions, EXPLORABLE_MOTIONS, params);
+  EXPECT_TRUE(after.empty());
+
+  vector<RangeResult> rangeAfter = opt.optimizeToRange(lines, Position(0, 0), RunningEffort(), Position(0, 8),
+                                                       Position(0, 17), "www", navContext, true,
+                                                       impliedExclusions, EXPLORABLE_MOTIONS, params);
+  EXPECT_TRUE(rangeAfter.empty());
+}
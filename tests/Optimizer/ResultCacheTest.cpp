@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+
+#include "Editor/NavContext.h"
+#include "Keyboard/MotionToKeys.h"
+#include "Optimizer/CompositionOptimizer.h"
+#include "Optimizer/Config.h"
+#include "Optimizer/DiffState.h"
+#include "Optimizer/ImpliedExclusions.h"
+#include "Optimizer/MovementOptimizer.h"
+#include "Optimizer/ResultCache.h"
+#include "State/RunningEffort.h"
+#include "Utils/Lines.h"
+#include "Utils/TestUtils.h"
+#include "lua_exports.h"
+
+using namespace std;
+
+class ResultCacheTest : public ::testing::Test {
+protected:
+  Lines lines = {"one two three four", "five six seven"};
+  Config config = Config::uniform();
+  NavContext navContext{20, 10};
+  ImpliedExclusions exclusions{false, false};
+  OptimizerParams params{5};
+
+  ResultCacheKey makeKey(Position start, Position end, const string& userSeq) const {
+    return ResultCacheKey(lines, start, end, userSeq, navContext, config, params, exclusions);
+  }
+
+  static CachedSearch makeValue(const string& seq, double cost) {
+    return CachedSearch{{Result(seq, cost)}, SearchStats{10, cost, false}};
+  }
+};
+
+TEST_F(ResultCacheTest, MissThenHit) {
+  ResultCache cache;
+  ResultCacheKey key = makeKey(Position(0, 0), Position(1, 5), "jw");
+
+  EXPECT_FALSE(cache.find(key).has_value());
+  cache.insert(key, makeValue("jw", 2.0));
+
+  optional<CachedSearch> hit = cache.find(key);
+  ASSERT_TRUE(hit.has_value());
+  ASSERT_EQ(hit->results.size(), 1u);
+  EXPECT_EQ(hit->results[0].getSequenceString(), "jw");
+  EXPECT_EQ(hit->stats.explored, 10);
+
+  EXPECT_EQ(cache.hits(), 1u);
+  EXPECT_EQ(cache.misses(), 1u);
+  EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST_F(ResultCacheTest, KeyCoversEveryInput) {
+  ResultCacheKey base = makeKey(Position(0, 0), Position(1, 5), "jw");
+  EXPECT_EQ(base, makeKey(Position(0, 0), Position(1, 5), "jw"));
+  EXPECT_EQ(ResultCacheKeyHash{}(base), ResultCacheKeyHash{}(makeKey(Position(0, 0), Position(1, 5), "jw")));
+
+  EXPECT_NE(base, makeKey(Position(0, 1), Position(1, 5), "jw"));
+  EXPECT_NE(base, makeKey(Position(0, 0), Position(1, 6), "jw"));
+  EXPECT_NE(base, makeKey(Position(0, 0), Position(1, 5), "jjw"));
+
+  lines[1] = "five six eight";
+  EXPECT_NE(base, makeKey(Position(0, 0), Position(1, 5), "jw"));
+  lines[1] = "five six seven";
+
+  config = Config::qwerty();
+  EXPECT_NE(base, makeKey(Position(0, 0), Position(1, 5), "jw"));
+  config = Config::uniform();
+
+  params.maxResults = 6;
+  EXPECT_NE(base, makeKey(Position(0, 0), Position(1, 5), "jw"));
+  params.maxResults = 5;
+
+  exclusions.exclude_G = true;
+  EXPECT_NE(base, makeKey(Position(0, 0), Position(1, 5), "jw"));
+  exclusions.exclude_G = false;
+
+  navContext.windowHeight = 40;
+  EXPECT_NE(base, makeKey(Position(0, 0), Position(1, 5), "jw"));
+}
+
+TEST_F(ResultCacheTest, LineBoundariesAffectBufferHash) {
+  EXPECT_NE(hashLines({"ab", "c"}), hashLines({"a", "bc"}));
+  EXPECT_NE(hashLines({"abc"}), hashLines({"abc", ""}));
+}
+
+TEST_F(ResultCacheTest, EvictsLeastRecentlyUsedWithinBudget) {
+  ResultCacheKey a = makeKey(Position(0, 0), Position(0, 4), "w");
+  ResultCacheKey b = makeKey(Position(0, 0), Position(0, 8), "ww");
+  ResultCacheKey c = makeKey(Position(0, 0), Position(0, 14), "www");
+
+  size_t entryBytes = ResultCache::estimateBytes(b, makeValue("ww", 2.0));
+  ResultCache cache(entryBytes * 2 + entryBytes / 2);
+
+  cache.insert(a, makeValue("w", 1.0));
+  cache.insert(b, makeValue("ww", 2.0));
+  EXPECT_TRUE(cache.find(a).has_value()); // a is now most recent
+  cache.insert(c, makeValue("www", 3.0));
+
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_LE(cache.bytes(), cache.maxBytes());
+  EXPECT_TRUE(cache.find(a).has_value());
+  EXPECT_FALSE(cache.find(b).has_value());
+  EXPECT_TRUE(cache.find(c).has_value());
+
+  cache.setMaxBytes(0);
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(cache.bytes(), 0u);
+
+  cache.insert(a, makeValue("w", 1.0));
+  EXPECT_EQ(cache.size(), 0u) << "Entries larger than the budget are not stored";
+}
+
+TEST_F(ResultCacheTest, CachedSearchMatchesFreshSearch) {
+  // Through the C API, so the handle's cache and its key are what is tested
+  VimficiencyHandle* handle = vimficiency_create();
+  auto analyze = [&] {
+    return vimficiency_analyze(handle, "one two three four\nfive six seven", true, true,
+                               0, 0, 1, 5, "jwl", 0, 1, 20, 10, 5);
+  };
+
+  const VimficiencyResults* first = analyze();
+  ASSERT_EQ(first->error, nullptr);
+  ASSERT_GT(first->count, 0u);
+  EXPECT_FALSE(first->stats.cached);
+  vector<AnalyzedResult> fresh = copyResults(first);  // Pointers die with the next call
+  int explored = first->stats.explored;
+
+  const VimficiencyResults* second = analyze();
+  ASSERT_EQ(second->error, nullptr);
+  EXPECT_TRUE(second->stats.cached);
+  EXPECT_EQ(copyResults(second), fresh);
+  EXPECT_EQ(second->stats.explored, explored);
+  VimficiencyCacheStats stats = vimficiency_cache_stats(handle);
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+
+  // Another config is another query
+  VimficiencyConfigFFI* config = vimficiency_get_config();
+  VimficiencyConfigFFI saved = *config;
+  config->weights.w_key = 2.0;
+  vimficiency_apply_config();
+  const VimficiencyResults* reconfigured = analyze();
+  EXPECT_FALSE(reconfigured->stats.cached);
+  EXPECT_EQ(vimficiency_cache_stats(handle).misses, 2u);
+
+  *config = saved;
+  vimficiency_apply_config();
+  vimficiency_destroy(handle);
+}
+
+// Renaming the same identifier on every other line gives identical edit regions
+static pair<Lines, Lines> repeatedRename(int lineCount) {
+  Lines before;
+  Lines after;
+  for (int i = 0; i < lineCount; i++) {
+    before.push_back(i % 2 == 0 ? "x = foo(y)" : "z");
+    after.push_back(i % 2 == 0 ? "x = bar(y)" : "z");
+  }
+  return {before, after};
+}
+
+static vector<DiffState> repeatedRenameDiffs(int lineCount) {
+  auto [before, after] = repeatedRename(lineCount);
+  return Myers::adjustForSequential(Myers::calculate(before, after));
+}
+
+TEST(EditResultCacheTest, IdenticalRegionsShareOneSolve) {
+  auto [before, after] = repeatedRename(8);
+  CompositionOptimizer optimizer(Config::uniform());
+  OptimizerParams params(5);
+  params.threads = 4;  // Search and scheduler tasks all claim the one shape
+  auto run = [&] {
+    optimizer.optimize(before, Position(0, 4), after, Position(0, 4), "cwbar<Esc>",
+                       NavContext(20, 10), ImpliedExclusions(), EXPLORABLE_MOTIONS, params);
+  };
+
+  run();
+  EXPECT_EQ(optimizer.editCache->size(), 1u);
+  EXPECT_EQ(optimizer.editCache->misses(), 1u);
+  EXPECT_EQ(optimizer.editCache->hits(), 0u);
+
+  // A later call is answered from the cache
+  run();
+  EXPECT_EQ(optimizer.editCache->misses(), 1u);
+  EXPECT_EQ(optimizer.editCache->hits(), 1u);
+}
+
+TEST(EditResultCacheTest, UnsolvedRegionsUseLowerBound) {
+  CompositionOptimizer optimizer(Config::uniform());
+  vector<DiffState> diffs = repeatedRenameDiffs(4);
+  ASSERT_EQ(diffs.size(), 2u);
+
+  // Nothing solved: each region counts its inserted characters
+  vector<SharedEditResult> results(diffs.size());
+  vector<double> bounds = optimizer.computeSuffixEditCosts(results, diffs);
+  EXPECT_DOUBLE_EQ(bounds[1], diffs[1].newCharCount());
+  EXPECT_DOUBLE_EQ(bounds[0], diffs[0].newCharCount() + diffs[1].newCharCount());
+  EXPECT_DOUBLE_EQ(bounds[2], 0.0);
+
+  // Solving one region replaces only its term
+  results[1] = optimizer.solveEditRegion(diffs[1], OptimizerParams());
+  vector<double> mixed = optimizer.computeSuffixEditCosts(results, diffs);
+  EXPECT_DOUBLE_EQ(mixed[1], optimizer.editCostEstimate(*results[1]));
+  EXPECT_DOUBLE_EQ(mixed[0] - mixed[1], diffs[0].newCharCount());
+
+  // Re-entering the same region is answered from the cache
+  EXPECT_EQ(optimizer.solveEditRegion(diffs[0], OptimizerParams()), results[1]);
+  EXPECT_EQ(optimizer.editCache->misses(), 1u);
+}
+
+TEST(EditResultCacheTest, BoundaryAndConfigAreInKey) {
+  vector<DiffState> diffs = repeatedRenameDiffs(2);
+  ASSERT_EQ(diffs.size(), 1u);
+  DiffState diff = diffs[0];
+
+  EditResultKey key(diff, hashConfig(Config::uniform()));
+  EXPECT_FALSE(key == EditResultKey(diff, hashConfig(Config::qwerty())));
+
+  DiffState otherBoundary = diff;
+  otherBoundary.boundary.hasLinesBelow = !diff.boundary.hasLinesBelow;
+  EXPECT_FALSE(key == EditResultKey(otherBoundary, hashConfig(Config::uniform())));
+}
+
+TEST(EditResultCacheTest, EvictsLeastRecentlyUsed) {
+  vector<DiffState> diffs = repeatedRenameDiffs(2);
+  EditResultCache cache(2);
+  auto value = make_shared<const EditResult>(1, 1);
+  EditResultKey a(diffs[0], 1), b(diffs[0], 2), c(diffs[0], 3);
+
+  cache.insert(a, value);
+  cache.insert(b, value);
+  EXPECT_NE(cache.find(a), nullptr); // a is now most recent
+  cache.insert(c, value);
+
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_NE(cache.find(a), nullptr);
+  EXPECT_EQ(cache.find(b), nullptr);
+  EXPECT_NE(cache.find(c), nullptr);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Utils/MpscQueue.h"
+
+using namespace std;
+
+TEST(MpscQueueTest, SingleThreadFifo) {
+  MpscQueue<int> queue;
+  EXPECT_FALSE(queue.pop().has_value());
+  for (int i = 0; i < 5; i++) {
+    queue.push(i);
+  }
+  for (int i = 0; i < 5; i++) {
+    optional<int> v = queue.pop();
+    ASSERT_TRUE(v.has_value());
+    EXPECT_EQ(*v, i);
+  }
+  EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(MpscQueueTest, ProducersKeepTheirOwnOrder) {
+  constexpr int PRODUCERS = 4;
+  constexpr int PER_PRODUCER = 5000;
+  MpscQueue<pair<int, int>> queue;
+
+  vector<jthread> producers;
+  for (int p = 0; p < PRODUCERS; p++) {
+    producers.emplace_back([&queue, p] {
+      for (int i = 0; i < PER_PRODUCER; i++) {
+        queue.push({p, i});
+      }
+    });
+  }
+
+  vector<int> next(PRODUCERS, 0);
+  int received = 0;
+  while (received < PRODUCERS * PER_PRODUCER) {
+    optional<pair<int, int>> v = queue.pop();
+    if (!v) {
+      this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(v->second, next[v->first]) << "producer " << v->first;
+    next[v->first]++;
+    received++;
+  }
+  EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(MpscQueueTest, DestroysUnpoppedValues) {
+  auto tracked = make_shared<int>(7);
+  {
+    MpscQueue<shared_ptr<int>> queue;
+    queue.push(tracked);
+    queue.push(tracked);
+    EXPECT_EQ(tracked.use_count(), 3);
+  }
+  EXPECT_EQ(tracked.use_count(), 1);
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utils/Debug.h"
+#include "Utils/ParallelFor.h"
+#include "Utils/TaskScheduler.h"
+#include "Utils/WorkStealingDeque.h"
+
+using namespace std;
+
+TEST(WorkStealingDequeTest, OwnerPopsNewestThievesStealOldest) {
+  WorkStealingDeque<int> deque(2);
+  for (int i = 0; i < 10; i++) {
+    deque.push(i);  // grows past the initial ring
+  }
+  EXPECT_EQ(deque.steal(), 0);
+  EXPECT_EQ(deque.pop(), 9);
+  EXPECT_EQ(deque.steal(), 1);
+  for (int i = 8; i >= 2; i--) {
+    EXPECT_EQ(deque.pop(), i);
+  }
+  EXPECT_FALSE(deque.pop().has_value());
+  EXPECT_FALSE(deque.steal().has_value());
+  EXPECT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDequeTest, EveryValueTakenOnce) {
+  constexpr int COUNT = 20000;
+  WorkStealingDeque<int> deque;
+  vector<atomic<int>> taken(COUNT);
+  atomic<bool> done{false};
+
+  vector<jthread> thieves;
+  for (int t = 0; t < 3; t++) {
+    thieves.emplace_back([&] {
+      while (!done.load()) {
+        if (optional<int> v = deque.steal()) taken[*v]++;
+      }
+    });
+  }
+  for (int i = 0; i < COUNT; i++) {
+    deque.push(i);
+    if (i % 3 == 0) {
+      if (optional<int> v = deque.pop()) taken[*v]++;
+    }
+  }
+  while (optional<int> v = deque.pop()) taken[*v]++;
+  done = true;
+  thieves.clear();
+
+  for (int i = 0; i < COUNT; i++) {
+    EXPECT_EQ(taken[i].load(), 1) << i;
+  }
+}
+
+TEST(TaskSchedulerTest, ParallelForVisitsEveryIndexOnce) {
+  TaskScheduler scheduler(3);
+  vector<atomic<int>> visits(1000);
+  parallelFor(visits.size(), 4, [&](size_t i) { visits[i]++; }, scheduler);
+  for (const auto& v : visits) {
+    EXPECT_EQ(v.load(), 1);
+  }
+}
+
+TEST(TaskSchedulerTest, NestedGroupsShareWorkers) {
+  // More nested forks than workers: waiting threads run queued tasks
+  TaskScheduler scheduler(2);
+  atomic<int> leaves{0};
+  TaskGroup outer(scheduler);
+  for (int i = 0; i < 8; i++) {
+    outer.run([&] {
+      TaskGroup inner(scheduler);
+      for (int j = 0; j < 8; j++) {
+        inner.run([&] { leaves++; });
+      }
+      inner.wait();
+    });
+  }
+  outer.wait();
+  EXPECT_EQ(leaves.load(), 64);
+}
+
+TEST(TaskSchedulerTest, ExceptionCancelsGroupAndIsRethrown) {
+  TaskScheduler scheduler(2);
+  EXPECT_THROW(
+    parallelFor(100, 3, [](size_t i) {
+      if (i == 10) throw runtime_error("boom");
+    }, scheduler),
+    runtime_error);
+
+  TaskGroup group(scheduler);
+  group.run([] { throw runtime_error("first"); });
+  EXPECT_THROW(group.wait(), runtime_error);
+  EXPECT_TRUE(group.isCancelled());
+}
+
+TEST(TaskSchedulerTest, CancelledGroupSkipsUnstartedTasks) {
+  TaskScheduler scheduler(1);
+  atomic<int> ran{0};
+  TaskGroup group(scheduler);
+  group.cancel();
+  for (int i = 0; i < 10; i++) {
+    group.run([&] { ran++; });
+  }
+  group.wait();
+  EXPECT_EQ(ran.load(), 0);
+}
+
+TEST(TaskSchedulerTest, TaskDebugOutputReachesWaitingThread) {
+  if constexpr (!DEBUG_ENABLED) {
+    GTEST_SKIP() << "debug output is compiled out";
+  }
+  TaskScheduler scheduler(2);
+  consume_debug_output();
+  TaskGroup outer(scheduler);
+  for (int i = 0; i < 4; i++) {
+    outer.run([i, &scheduler] {
+      TaskGroup inner(scheduler);
+      inner.run([i] { debug("inner", i); });
+      inner.wait();
+      debug("outer", i);
+    });
+  }
+  outer.wait();
+
+  string output = consume_debug_output();
+  for (int i = 0; i < 4; i++) {
+    EXPECT_NE(output.find("inner " + to_string(i) + "\n"), string::npos) << output;
+    EXPECT_NE(output.find("outer " + to_string(i) + "\n"), string::npos) << output;
+  }
+}
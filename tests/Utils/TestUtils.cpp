@@ -26,3 +26,16 @@ void printResults(vector<Result>& results) {
   }
   cout << endl;
 }
+
+vector<AnalyzedResult> copyResults(const VimficiencyResults* out) {
+  vector<AnalyzedResult> copied;
+  for (size_t i = 0; i < out->count; i++) {
+    const VimficiencyResult& r = out->results[i];
+    AnalyzedResult& c = copied.emplace_back(
+        AnalyzedResult{string(r.seq, r.seq_len), r.cost, r.end_row, r.end_col, {}});
+    for (size_t k = 0; k < r.segment_count; k++) {
+      c.segments.emplace_back(r.segments[k].mode, string(r.segments[k].keys, r.segments[k].keys_len));
+    }
+  }
+  return copied;
+}
@@ -3,6 +3,7 @@
 #include "Optimizer/Result.h"
 #include "Keyboard/KeyboardModel.h"
 #include "Utils/StringUtils.h"
+#include "lua_exports.h"
 
 #include <bits/stdc++.h>
 using namespace std;
@@ -39,3 +40,17 @@ bool contains_all(const vector<Result>& v, initializer_list<string> need);
 
 void printResults(vector<Result>& results);
 
+
+// What a caller of the C API can observe of one analysis result
+struct AnalyzedResult {
+  string seq;
+  double cost;
+  int endRow;
+  int endCol;
+  vector<pair<int, string>> segments;
+
+  bool operator==(const AnalyzedResult& other) const = default;
+};
+
+// Copies results out of the handle's arena, whose pointers die with the next call
+vector<AnalyzedResult> copyResults(const VimficiencyResults* out);
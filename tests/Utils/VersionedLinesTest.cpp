@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "Optimizer/CompositionOptimizer.h"
+#include "Optimizer/Config.h"
+#include "Optimizer/DiffState.h"
+#include "Utils/Lines.h"
+#include "Utils/VersionedLines.h"
+
+using namespace std;
+
+TEST(VersionedLinesTest, LinesThroughTheChain) {
+  VersionedLines versions({"zero", "one", "two", "three"});
+  versions.push(1, 2, {"ONE"});              // zero ONE three
+  versions.push(0, 0, {"head", "first"});    // head first zero ONE three
+  versions.push(4, 1, {"3a", "3b", "3c"});   // head first zero ONE 3a 3b 3c
+
+  ASSERT_EQ(versions.versions(), 4);
+  EXPECT_EQ(versions.lineCount(0), 4);
+  EXPECT_EQ(versions.lineCount(1), 3);
+  EXPECT_EQ(versions.lineCount(3), 7);
+
+  vector<Lines> expected = {
+    {"zero", "one", "two", "three"},
+    {"zero", "ONE", "three"},
+    {"head", "first", "zero", "ONE", "three"},
+    {"head", "first", "zero", "ONE", "3a", "3b", "3c"},
+  };
+  for (int v = 0; v < versions.versions(); v++) {
+    EXPECT_EQ(*versions.lines(v), expected[v]) << "version " << v;
+    for (int i = 0; i < versions.lineCount(v); i++) {
+      EXPECT_EQ(versions.line(v, i), expected[v][i]) << "version " << v << " line " << i;
+    }
+  }
+  EXPECT_EQ(versions.tip(), expected.back());
+}
+
+TEST(VersionedLinesTest, CachedVersionsAreShared) {
+  VersionedLines versions({"a", "b"}, 2);
+  versions.push(0, 1, {"x"});
+  versions.push(1, 1, {"y"});
+
+  SharedLines second = versions.lines(2);
+  EXPECT_EQ(versions.lines(2), second);
+
+  // Evicting it only drops the cache's reference
+  versions.lines(1);
+  versions.lines(0);
+  versions.lines(1);
+  EXPECT_EQ(*second, Lines({"x", "y"}));
+  EXPECT_EQ(*versions.lines(2), Lines({"x", "y"}));
+}
+
+TEST(VersionedLinesTest, MatchesSequentialDiffApplication) {
+  // Changes on separate lines, so each diff's position holds after the earlier ones
+  Lines start = {
+    "int main() {",
+    "  int count = 0;",
+    "  for (int i = 0; i < n; i++) {",
+    "    count += values[i];",
+    "  }",
+    "  return count;",
+    "}",
+  };
+  Lines end = {
+    "int main(int argc) {",
+    "  long count = 0;",
+    "  for (int i = 0; i < n; i++) {",
+    "    count += weights[i];",
+    "  }",
+    "  return count;",
+    "}",
+  };
+
+  vector<DiffState> diffs = Myers::adjustForSequential(Myers::calculate(start, end));
+  ASSERT_GE(diffs.size(), 2u);
+
+  CompositionOptimizer optimizer(Config::uniform());
+  VersionedLines versions = optimizer.calculateLinesAfterDiffs(start, diffs, static_cast<int>(diffs.size()));
+
+  Lines expected = start;
+  for (size_t i = 0; i < diffs.size(); i++) {
+    expected = Myers::applyDiffState(diffs[i], expected);
+    EXPECT_EQ(*versions.lines(static_cast<int>(i) + 1), expected) << "after diff " << i;
+  }
+  EXPECT_EQ(versions.tip(), end);
+}